@@ -0,0 +1,346 @@
+/**
+ **********************************************************************************************************************
+ * @file       bcastring.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Single-producer, multi-consumer broadcast byte ring.
+ **********************************************************************************************************************
+ */
+
+#include "bcastring.h"
+
+#include <malloc.h>
+#include <string.h>
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Failed attempts a blocking call spins before it goes to sleep. */
+#define BLOCKING_SPIN_COUNT         ( 200 )
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static LONG64 GatePosition( tBcastRing* pRing, LONG64 published );
+static void   WakeWaiters( volatile LONG* pEpoch, volatile LONG* pWaiters );
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+BOOL BcastRing_Init( tBcastRing* pRing, size_t capacity )
+{
+    memset( ( void * ) pRing, 0, sizeof( *pRing ) );
+    if ( capacity < 2 || ( capacity & ( capacity - 1 ) ) != 0 )
+    {
+        return FALSE;
+    }
+
+    pRing->pBuffer = _aligned_malloc( capacity, BCASTRING_CACHE_LINE );
+    if ( pRing->pBuffer == NULL )
+    {
+        return FALSE;
+    }
+    pRing->capacity = ( LONG64 ) capacity;
+    pRing->mask     = ( LONG64 ) capacity - 1;
+    return TRUE;
+}
+
+void BcastRing_Destroy( tBcastRing* pRing )
+{
+    _aligned_free( pRing->pBuffer );
+    pRing->pBuffer = NULL;
+}
+
+int BcastRing_AddConsumer( tBcastRing* pRing, BOOL lossy )
+{
+    for ( int i = 0; i < BCASTRING_MAX_CONSUMERS; ++i )
+    {
+        tBcastCursor* pCursor = &pRing->cursors[ i ];
+        if ( pCursor->active )
+        {
+            continue;
+        }
+
+        pCursor->position        = ReadAcquire64( &pRing->published );
+        pCursor->cachedPublished = pCursor->position;
+        pCursor->pendingLost     = 0;
+        pCursor->lostBytes       = 0;
+        pCursor->lossy           = lossy;
+
+        /* Publish the cursor to the producer only once it is set up. */
+        InterlockedExchange( &pCursor->active, TRUE );
+        return i;
+    }
+    return -1;
+}
+
+void BcastRing_RemoveConsumer( tBcastRing* pRing, int consumer )
+{
+    InterlockedExchange( &pRing->cursors[ consumer ].active, FALSE );
+    WakeWaiters( &pRing->spaceEpoch, &pRing->producerWaiters );
+}
+
+uint8_t* BcastRing_TryClaim( tBcastRing* pRing, size_t* pSize )
+{
+    LONG64 published = ReadNoFence64( &pRing->published );
+    LONG64 offset    = published & pRing->mask;
+    LONG64 wanted    = pRing->capacity - offset;
+
+    if ( ( LONG64 ) *pSize < wanted )
+    {
+        wanted = ( LONG64 ) *pSize;
+    }
+
+    /* Only look at the consumers' cursors when the cached slowest one does not leave enough room. */
+    if ( pRing->cachedGate + pRing->capacity - published < wanted )
+    {
+        pRing->cachedGate = GatePosition( pRing, published );
+    }
+
+    LONG64 size = pRing->cachedGate + pRing->capacity - published;
+    if ( size > wanted )
+    {
+        size = wanted;
+    }
+    if ( size <= 0 )
+    {
+        *pSize = 0;
+        return NULL;
+    }
+
+    /* Tell lossy consumers which bytes are about to be overwritten, before writing any of them. */
+    if ( published + size > pRing->claimed )
+    {
+        InterlockedExchange64( &pRing->claimed, published + size );
+    }
+    *pSize = ( size_t ) size;
+    return pRing->pBuffer + offset;
+}
+
+uint8_t* BcastRing_Claim( tBcastRing* pRing, size_t* pSize )
+{
+    size_t   wanted = *pSize;
+    unsigned spins  = 0;
+
+    while ( !pRing->closed )
+    {
+        uint8_t* pSpan;
+
+        *pSize = wanted;
+        pSpan  = BcastRing_TryClaim( pRing, pSize );
+        if ( pSpan == NULL && ++spins > BLOCKING_SPIN_COUNT )
+        {
+            /* Announce ourselves before the last attempt, so that any release after it is guaranteed to wake us. */
+            InterlockedIncrement( &pRing->producerWaiters );
+            LONG epoch = pRing->spaceEpoch;
+            *pSize = wanted;
+            pSpan  = BcastRing_TryClaim( pRing, pSize );
+            if ( pSpan == NULL && !pRing->closed )
+            {
+                WaitOnAddress( &pRing->spaceEpoch, &epoch, sizeof( epoch ), INFINITE );
+            }
+            InterlockedDecrement( &pRing->producerWaiters );
+            spins = 0;
+        }
+        else if ( pSpan == NULL )
+        {
+            YieldProcessor();
+        }
+
+        if ( pSpan != NULL )
+        {
+            return pSpan;
+        }
+    }
+    *pSize = 0;
+    return NULL;
+}
+
+void BcastRing_Publish( tBcastRing* pRing, size_t size )
+{
+    WriteRelease64( &pRing->published, ReadNoFence64( &pRing->published ) + ( LONG64 ) size );
+    WakeWaiters( &pRing->dataEpoch, &pRing->consumerWaiters );
+}
+
+size_t BcastRing_Write( tBcastRing* pRing, void const * pData, size_t size )
+{
+    size_t written = 0;
+
+    while ( written < size )
+    {
+        size_t   n     = size - written;
+        uint8_t* pSpan = BcastRing_Claim( pRing, &n );
+
+        if ( pSpan == NULL )
+        {
+            break;
+        }
+        memcpy( pSpan, ( uint8_t const * ) pData + written, n );
+        BcastRing_Publish( pRing, n );
+        written += n;
+    }
+    return written;
+}
+
+void BcastRing_Close( tBcastRing* pRing )
+{
+    InterlockedExchange( &pRing->closed, TRUE );
+    InterlockedIncrement( &pRing->dataEpoch );
+    InterlockedIncrement( &pRing->spaceEpoch );
+    WakeByAddressAll( ( PVOID ) &pRing->dataEpoch );
+    WakeByAddressAll( ( PVOID ) &pRing->spaceEpoch );
+}
+
+BOOL BcastRing_TryPeek( tBcastRing* pRing, int consumer, tBcastSpan* pSpan )
+{
+    tBcastCursor* pCursor  = &pRing->cursors[ consumer ];
+    LONG64        position = pCursor->position;
+
+    if ( pCursor->lossy )
+    {
+        /* Read claimed before published, so that the oldest intact byte is never past the newest published one. */
+        LONG64 oldest = ReadAcquire64( &pRing->claimed ) - pRing->capacity;
+        pCursor->cachedPublished = ReadAcquire64( &pRing->published );
+        if ( position < oldest )
+        {
+            pCursor->pendingLost += ( uint64_t ) ( oldest - position );
+            pCursor->lostBytes   += ( uint64_t ) ( oldest - position );
+            position = oldest;
+            WriteNoFence64( &pCursor->position, position );
+        }
+    }
+    else if ( pCursor->cachedPublished <= position )
+    {
+        pCursor->cachedPublished = ReadAcquire64( &pRing->published );
+    }
+
+    if ( pCursor->cachedPublished <= position )
+    {
+        return FALSE;
+    }
+
+    LONG64 offset = position & pRing->mask;
+    LONG64 size   = pCursor->cachedPublished - position;
+    if ( size > pRing->capacity - offset )
+    {
+        size = pRing->capacity - offset;
+    }
+    pSpan->pData         = pRing->pBuffer + offset;
+    pSpan->size          = ( size_t ) size;
+    pSpan->lost          = pCursor->pendingLost;
+    pCursor->pendingLost = 0;
+    return TRUE;
+}
+
+BOOL BcastRing_Peek( tBcastRing* pRing, int consumer, tBcastSpan* pSpan )
+{
+    unsigned spins = 0;
+
+    while ( TRUE )
+    {
+        if ( BcastRing_TryPeek( pRing, consumer, pSpan ) )
+        {
+            return TRUE;
+        }
+        if ( ReadAcquire( &pRing->closed ) )
+        {
+            /* Everything was published before the ring was closed, look once more. */
+            return BcastRing_TryPeek( pRing, consumer, pSpan );
+        }
+
+        if ( ++spins > BLOCKING_SPIN_COUNT )
+        {
+            /* Announce ourselves before the last attempt, so that any publish after it is guaranteed to wake us. */
+            InterlockedIncrement( &pRing->consumerWaiters );
+            LONG epoch = pRing->dataEpoch;
+            BOOL found = BcastRing_TryPeek( pRing, consumer, pSpan );
+            if ( !found && !pRing->closed )
+            {
+                WaitOnAddress( &pRing->dataEpoch, &epoch, sizeof( epoch ), INFINITE );
+            }
+            InterlockedDecrement( &pRing->consumerWaiters );
+            if ( found )
+            {
+                return TRUE;
+            }
+            spins = 0;
+        }
+        else
+        {
+            YieldProcessor();
+        }
+    }
+}
+
+BOOL BcastRing_Release( tBcastRing* pRing, int consumer, size_t size )
+{
+    tBcastCursor* pCursor = &pRing->cursors[ consumer ];
+    LONG64        start   = pCursor->position;
+    BOOL          intact  = TRUE;
+
+    if ( pCursor->lossy )
+    {
+        /* Finish reading the span before checking whether the producer has claimed it since. */
+        MemoryBarrier();
+        if ( ReadAcquire64( &pRing->claimed ) - pRing->capacity > start )
+        {
+            pCursor->pendingLost += size;
+            pCursor->lostBytes   += size;
+            intact = FALSE;
+        }
+        WriteNoFence64( &pCursor->position, start + ( LONG64 ) size );
+        return intact;
+    }
+
+    WriteRelease64( &pCursor->position, start + ( LONG64 ) size );
+    WakeWaiters( &pRing->spaceEpoch, &pRing->producerWaiters );
+    return intact;
+}
+
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Cursor of the slowest consumer that gates the producer, published if there is none. */
+static LONG64 GatePosition( tBcastRing* pRing, LONG64 published )
+{
+    LONG64 gate = published;
+
+    for ( int i = 0; i < BCASTRING_MAX_CONSUMERS; ++i )
+    {
+        tBcastCursor* pCursor = &pRing->cursors[ i ];
+        if ( ReadAcquire( &pCursor->active ) && !pCursor->lossy )
+        {
+            LONG64 position = ReadAcquire64( &pCursor->position );
+            if ( position < gate )
+            {
+                gate = position;
+            }
+        }
+    }
+    return gate;
+}
+
+static void WakeWaiters( volatile LONG* pEpoch, volatile LONG* pWaiters )
+{
+    /* Order the preceding publish/release before reading the waiter count (pairs with the waiter's increment). */
+    MemoryBarrier();
+    if ( *pWaiters != 0 )
+    {
+        InterlockedIncrement( pEpoch );
+        WakeByAddressAll( ( PVOID ) pEpoch );
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ **********************************************************************************************************************
+ * @file       bcastring.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Single-producer, multi-consumer broadcast byte ring.
+ *
+ * Every consumer sees every byte, like the Disruptor: the producer writes each byte once and every consumer reads it
+ * in place through its own cursor, instead of the producer copying its buffer once per consumer. The producer claims
+ * a contiguous span (e.g. to ReadFile straight into it), fills it and publishes it. Consumers peek the contiguous span
+ * after their cursor, process it in place and release it.
+ *
+ * Normal consumers gate the producer: it never overwrites bytes the slowest of them has not released. Lossy consumers
+ * (e.g. a live monitor) do not; when they fall a full ring behind they skip ahead to the oldest intact byte, and the
+ * next span reports how many bytes they lost. Because a lossy consumer's span can be overwritten while it is held,
+ * BcastRing_Release() tells it afterwards whether what it read was intact.
+ *
+ * Consumers should be added before the producer starts; one added while it runs may lose its first bytes. Waiting
+ * sleeps on WaitOnAddress, like tBlockingQueue in lfqueue.h.
+ **********************************************************************************************************************
+ */
+
+#ifndef BCASTRING_H
+#define BCASTRING_H
+
+#include <windows.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Size of a cache line, used to keep producer and consumer state apart. */
+#define BCASTRING_CACHE_LINE        ( 64 )
+
+/* Max number of consumers of a ring. */
+#define BCASTRING_MAX_CONSUMERS     ( 16 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Read position of one consumer, on a cache line of its own. */
+typedef struct __declspec( align( BCASTRING_CACHE_LINE ) ) sBcastCursor
+{
+    volatile LONG64 position;                                           /* Next byte to read.                */
+    LONG64          cachedPublished;                                    /* Consumer's copy of published.     */
+    uint64_t        pendingLost;                                        /* Lost bytes not yet reported.      */
+    uint64_t        lostBytes;                                          /* Total lost bytes.                 */
+    volatile LONG   active;                                             /* Added and not removed.            */
+    BOOL            lossy;                                              /* Does not gate the producer.       */
+    char            pad0[ BCASTRING_CACHE_LINE - 4 * sizeof( LONG64 ) - 2 * sizeof( LONG ) ];
+} tBcastCursor;
+
+/* Broadcast ring. */
+typedef struct __declspec( align( BCASTRING_CACHE_LINE ) ) sBcastRing
+{
+    volatile LONG64 claimed;                                            /* End of bytes being written.       */
+    volatile LONG64 published;                                          /* End of bytes visible to readers.  */
+    LONG64          cachedGate;                                         /* Producer's copy of slowest cursor. */
+    char            pad0[ BCASTRING_CACHE_LINE - 3 * sizeof( LONG64 ) ];
+    volatile LONG   dataEpoch;                                          /* Bumped to wake consumers.         */
+    volatile LONG   consumerWaiters;                                    /* Consumers about to sleep.         */
+    volatile LONG   closed;                                             /* Set by BcastRing_Close.           */
+    char            pad1[ BCASTRING_CACHE_LINE - 3 * sizeof( LONG ) ];
+    volatile LONG   spaceEpoch;                                         /* Bumped to wake the producer.      */
+    volatile LONG   producerWaiters;                                    /* Producer about to sleep.          */
+    char            pad2[ BCASTRING_CACHE_LINE - 2 * sizeof( LONG ) ];
+    uint8_t*        pBuffer;                                            /* Ring buffer.                      */
+    LONG64          capacity;                                           /* Size of ring buffer.              */
+    LONG64          mask;                                               /* Capacity - 1.                     */
+    tBcastCursor    cursors[ BCASTRING_MAX_CONSUMERS ];                 /* Consumer cursors.                 */
+} tBcastRing;
+
+/* Contiguous span handed to a consumer. */
+typedef struct sBcastSpan
+{
+    uint8_t const * pData;      /* First byte.                                                   */
+    size_t          size;       /* Number of bytes, never more than the ring's capacity.        */
+    uint64_t        lost;       /* Bytes skipped just before this span (lossy consumers only).  */
+} tBcastSpan;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/* Ring of capacity bytes, which must be a power of two. */
+BOOL     BcastRing_Init( tBcastRing* pRing, size_t capacity );
+void     BcastRing_Destroy( tBcastRing* pRing );
+
+/* Add a consumer starting at the newest byte. Returns its ID, or -1 if all consumer slots are taken. */
+int      BcastRing_AddConsumer( tBcastRing* pRing, BOOL lossy );
+
+/* Remove a consumer, so that it no longer gates the producer. */
+void     BcastRing_RemoveConsumer( tBcastRing* pRing, int consumer );
+
+/*
+ * Producer: claim up to *pSize contiguous bytes to write. Sets *pSize to the number of bytes granted and returns where
+ * to write them, or NULL if the ring is full (Try) or closed. Publish at most the granted number of bytes afterwards.
+ */
+uint8_t* BcastRing_TryClaim( tBcastRing* pRing, size_t* pSize );
+uint8_t* BcastRing_Claim( tBcastRing* pRing, size_t* pSize );
+void     BcastRing_Publish( tBcastRing* pRing, size_t size );
+
+/* Producer: copy size bytes in, sleeping while the ring is full. Returns fewer than size only if it was closed. */
+size_t   BcastRing_Write( tBcastRing* pRing, void const * pData, size_t size );
+
+/* Producer: no more bytes. Consumers can still read what was published. */
+void     BcastRing_Close( tBcastRing* pRing );
+
+/*
+ * Consumer: get the contiguous span of published bytes after the consumer's cursor. TryPeek returns FALSE if there is
+ * none, Peek sleeps until there is and returns FALSE only once the ring is closed and drained.
+ */
+BOOL     BcastRing_TryPeek( tBcastRing* pRing, int consumer, tBcastSpan* pSpan );
+BOOL     BcastRing_Peek( tBcastRing* pRing, int consumer, tBcastSpan* pSpan );
+
+/*
+ * Consumer: done with the first size bytes of the span. Returns FALSE if the producer overwrote them while they were
+ * held (lossy consumers only), in which case they count as lost and whatever was read from them must be discarded.
+ */
+BOOL     BcastRing_Release( tBcastRing* pRing, int consumer, size_t size );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BCASTRING_H */
@@ -0,0 +1,506 @@
+/**
+ **********************************************************************************************************************
+ * @file       lfqueue.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Bounded lock-free queues of pointers, plus blocking wrappers.
+ **********************************************************************************************************************
+ */
+
+#include "lfqueue.h"
+
+#include <malloc.h>
+#include <string.h>
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Failed attempts a blocking call spins before it goes to sleep. */
+#define BLOCKING_SPIN_COUNT         ( 200 )
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static BOOL   IsPowerOfTwo( size_t value );
+static size_t TryPushBatch( tBlockingQueue* pQueue, void* const * ppItems, size_t count );
+static size_t TryPopBatch( tBlockingQueue* pQueue, void** ppItems, size_t count );
+static void   WakeWaiters( volatile LONG* pEpoch, volatile LONG* pWaiters );
+
+/**
+ **********************************************************************************************************************
+ * Public functions: MPMC
+ **********************************************************************************************************************
+ */
+
+BOOL MpmcQueue_Init( tMpmcQueue* pQueue, size_t capacity )
+{
+    memset( ( void * ) pQueue, 0, sizeof( *pQueue ) );
+    if ( capacity < 2 || !IsPowerOfTwo( capacity ) )
+    {
+        return FALSE;
+    }
+
+    pQueue->pCells = _aligned_malloc( capacity * sizeof( tQueueCell ), LFQUEUE_CACHE_LINE );
+    if ( pQueue->pCells == NULL )
+    {
+        return FALSE;
+    }
+    for ( size_t i = 0; i < capacity; ++i )
+    {
+        pQueue->pCells[ i ].sequence = ( LONG64 ) i;
+        pQueue->pCells[ i ].pData    = NULL;
+    }
+    pQueue->mask = ( LONG64 ) capacity - 1;
+    return TRUE;
+}
+
+void MpmcQueue_Destroy( tMpmcQueue* pQueue )
+{
+    _aligned_free( pQueue->pCells );
+    pQueue->pCells = NULL;
+}
+
+BOOL MpmcQueue_TryPush( tMpmcQueue* pQueue, void* pData )
+{
+    return MpmcQueue_TryPushBatch( pQueue, &pData, 1 ) == 1;
+}
+
+BOOL MpmcQueue_TryPop( tMpmcQueue* pQueue, void** ppData )
+{
+    return MpmcQueue_TryPopBatch( pQueue, ppData, 1 ) == 1;
+}
+
+size_t MpmcQueue_TryPushBatch( tMpmcQueue* pQueue, void* const * ppItems, size_t count )
+{
+    LONG64 pos = ReadNoFence64( &pQueue->enqueuePos );
+
+    if ( count == 0 )
+    {
+        return 0;
+    }
+
+    while ( TRUE )
+    {
+        /* Count consecutive cells that are free for this lap. */
+        size_t n = 0;
+        while ( n < count &&
+                ReadAcquire64( &pQueue->pCells[ ( pos + n ) & pQueue->mask ].sequence ) == pos + ( LONG64 ) n )
+        {
+            ++n;
+        }
+
+        if ( n == 0 )
+        {
+            LONG64 diff = ReadAcquire64( &pQueue->pCells[ pos & pQueue->mask ].sequence ) - pos;
+            if ( diff < 0 )
+            {
+                /* Cell still holds an item from the previous lap: full. */
+                return 0;
+            }
+            /* Another producer got here first. */
+            pos = ReadNoFence64( &pQueue->enqueuePos );
+            continue;
+        }
+
+        LONG64 prev = InterlockedCompareExchange64( &pQueue->enqueuePos, pos + ( LONG64 ) n, pos );
+        if ( prev == pos )
+        {
+            for ( size_t i = 0; i < n; ++i )
+            {
+                tQueueCell* pCell = &pQueue->pCells[ ( pos + i ) & pQueue->mask ];
+                pCell->pData = ppItems[ i ];
+                WriteRelease64( &pCell->sequence, pos + ( LONG64 ) i + 1 );
+            }
+            return n;
+        }
+        pos = prev;
+    }
+}
+
+size_t MpmcQueue_TryPopBatch( tMpmcQueue* pQueue, void** ppItems, size_t count )
+{
+    LONG64 pos = ReadNoFence64( &pQueue->dequeuePos );
+
+    if ( count == 0 )
+    {
+        return 0;
+    }
+
+    while ( TRUE )
+    {
+        /* Count consecutive cells that are full for this lap. */
+        size_t n = 0;
+        while ( n < count &&
+                ReadAcquire64( &pQueue->pCells[ ( pos + n ) & pQueue->mask ].sequence ) == pos + ( LONG64 ) n + 1 )
+        {
+            ++n;
+        }
+
+        if ( n == 0 )
+        {
+            LONG64 diff = ReadAcquire64( &pQueue->pCells[ pos & pQueue->mask ].sequence ) - ( pos + 1 );
+            if ( diff < 0 )
+            {
+                /* Cell not written yet for this lap: empty. */
+                return 0;
+            }
+            /* Another consumer got here first. */
+            pos = ReadNoFence64( &pQueue->dequeuePos );
+            continue;
+        }
+
+        LONG64 prev = InterlockedCompareExchange64( &pQueue->dequeuePos, pos + ( LONG64 ) n, pos );
+        if ( prev == pos )
+        {
+            for ( size_t i = 0; i < n; ++i )
+            {
+                tQueueCell* pCell = &pQueue->pCells[ ( pos + i ) & pQueue->mask ];
+                ppItems[ i ] = pCell->pData;
+                WriteRelease64( &pCell->sequence, pos + ( LONG64 ) i + pQueue->mask + 1 );
+            }
+            return n;
+        }
+        pos = prev;
+    }
+}
+
+/**
+ **********************************************************************************************************************
+ * Public functions: MPSC
+ **********************************************************************************************************************
+ */
+
+BOOL MpscQueue_Init( tMpscQueue* pQueue, size_t capacity )
+{
+    return MpmcQueue_Init( pQueue, capacity );
+}
+
+void MpscQueue_Destroy( tMpscQueue* pQueue )
+{
+    MpmcQueue_Destroy( pQueue );
+}
+
+BOOL MpscQueue_TryPush( tMpscQueue* pQueue, void* pData )
+{
+    return MpmcQueue_TryPushBatch( pQueue, &pData, 1 ) == 1;
+}
+
+BOOL MpscQueue_TryPop( tMpscQueue* pQueue, void** ppData )
+{
+    return MpscQueue_TryPopBatch( pQueue, ppData, 1 ) == 1;
+}
+
+size_t MpscQueue_TryPushBatch( tMpscQueue* pQueue, void* const * ppItems, size_t count )
+{
+    return MpmcQueue_TryPushBatch( pQueue, ppItems, count );
+}
+
+size_t MpscQueue_TryPopBatch( tMpscQueue* pQueue, void** ppItems, size_t count )
+{
+    /* Only this thread moves dequeuePos, so no compare-exchange is needed. */
+    LONG64 pos = pQueue->dequeuePos;
+    size_t n   = 0;
+
+    while ( n < count )
+    {
+        tQueueCell* pCell = &pQueue->pCells[ ( pos + n ) & pQueue->mask ];
+        if ( ReadAcquire64( &pCell->sequence ) != pos + ( LONG64 ) n + 1 )
+        {
+            break;
+        }
+        ppItems[ n ] = pCell->pData;
+        WriteRelease64( &pCell->sequence, pos + ( LONG64 ) n + pQueue->mask + 1 );
+        ++n;
+    }
+    pQueue->dequeuePos = pos + ( LONG64 ) n;
+    return n;
+}
+
+/**
+ **********************************************************************************************************************
+ * Public functions: SPSC
+ **********************************************************************************************************************
+ */
+
+BOOL SpscQueue_Init( tSpscQueue* pQueue, size_t capacity )
+{
+    memset( ( void * ) pQueue, 0, sizeof( *pQueue ) );
+    if ( capacity < 2 || !IsPowerOfTwo( capacity ) )
+    {
+        return FALSE;
+    }
+
+    pQueue->ppItems = _aligned_malloc( capacity * sizeof( void * ), LFQUEUE_CACHE_LINE );
+    if ( pQueue->ppItems == NULL )
+    {
+        return FALSE;
+    }
+    pQueue->mask = ( LONG64 ) capacity - 1;
+    return TRUE;
+}
+
+void SpscQueue_Destroy( tSpscQueue* pQueue )
+{
+    _aligned_free( pQueue->ppItems );
+    pQueue->ppItems = NULL;
+}
+
+BOOL SpscQueue_TryPush( tSpscQueue* pQueue, void* pData )
+{
+    return SpscQueue_TryPushBatch( pQueue, &pData, 1 ) == 1;
+}
+
+BOOL SpscQueue_TryPop( tSpscQueue* pQueue, void** ppData )
+{
+    return SpscQueue_TryPopBatch( pQueue, ppData, 1 ) == 1;
+}
+
+size_t SpscQueue_TryPushBatch( tSpscQueue* pQueue, void* const * ppItems, size_t count )
+{
+    LONG64 tail     = pQueue->tail;
+    LONG64 capacity = pQueue->mask + 1;
+    LONG64 space    = capacity - ( tail - pQueue->cachedHead );
+
+    /* Only look at the consumer's cache line when the cached view says there is not enough room. */
+    if ( space < ( LONG64 ) count )
+    {
+        pQueue->cachedHead = ReadAcquire64( &pQueue->head );
+        space              = capacity - ( tail - pQueue->cachedHead );
+    }
+
+    size_t n = ( space < ( LONG64 ) count ) ? ( size_t ) space : count;
+    for ( size_t i = 0; i < n; ++i )
+    {
+        pQueue->ppItems[ ( tail + i ) & pQueue->mask ] = ppItems[ i ];
+    }
+    if ( n != 0 )
+    {
+        WriteRelease64( &pQueue->tail, tail + ( LONG64 ) n );
+    }
+    return n;
+}
+
+size_t SpscQueue_TryPopBatch( tSpscQueue* pQueue, void** ppItems, size_t count )
+{
+    LONG64 head      = pQueue->head;
+    LONG64 available = pQueue->cachedTail - head;
+
+    /* Only look at the producer's cache line when the cached view says there is not enough. */
+    if ( available < ( LONG64 ) count )
+    {
+        pQueue->cachedTail = ReadAcquire64( &pQueue->tail );
+        available          = pQueue->cachedTail - head;
+    }
+
+    size_t n = ( available < ( LONG64 ) count ) ? ( size_t ) available : count;
+    for ( size_t i = 0; i < n; ++i )
+    {
+        ppItems[ i ] = pQueue->ppItems[ ( head + i ) & pQueue->mask ];
+    }
+    if ( n != 0 )
+    {
+        WriteRelease64( &pQueue->head, head + ( LONG64 ) n );
+    }
+    return n;
+}
+
+/**
+ **********************************************************************************************************************
+ * Public functions: blocking wrapper
+ **********************************************************************************************************************
+ */
+
+BOOL BlockingQueue_Init( tBlockingQueue* pQueue, tQueueKind kind, size_t capacity )
+{
+    memset( ( void * ) pQueue, 0, sizeof( *pQueue ) );
+    pQueue->kind = kind;
+    if ( kind == QUEUE_KIND_SPSC )
+    {
+        return SpscQueue_Init( &pQueue->u.spsc, capacity );
+    }
+    return MpmcQueue_Init( &pQueue->u.mpmc, capacity );
+}
+
+void BlockingQueue_Destroy( tBlockingQueue* pQueue )
+{
+    if ( pQueue->kind == QUEUE_KIND_SPSC )
+    {
+        SpscQueue_Destroy( &pQueue->u.spsc );
+    }
+    else
+    {
+        MpmcQueue_Destroy( &pQueue->u.mpmc );
+    }
+}
+
+size_t BlockingQueue_PushBatch( tBlockingQueue* pQueue, void* const * ppItems, size_t count )
+{
+    size_t   pushed = 0;
+    unsigned spins  = 0;
+
+    while ( pushed < count && !pQueue->closed )
+    {
+        size_t n = TryPushBatch( pQueue, ppItems + pushed, count - pushed );
+
+        if ( n == 0 && ++spins > BLOCKING_SPIN_COUNT )
+        {
+            /* Announce ourselves before the last attempt, so that any pop after it is guaranteed to wake us. */
+            InterlockedIncrement( &pQueue->pushWaiters );
+            LONG epoch = pQueue->notFullEpoch;
+            n = TryPushBatch( pQueue, ppItems + pushed, count - pushed );
+            if ( n == 0 && !pQueue->closed )
+            {
+                WaitOnAddress( &pQueue->notFullEpoch, &epoch, sizeof( epoch ), INFINITE );
+            }
+            InterlockedDecrement( &pQueue->pushWaiters );
+            spins = 0;
+        }
+        else if ( n == 0 )
+        {
+            YieldProcessor();
+        }
+
+        if ( n != 0 )
+        {
+            pushed += n;
+            WakeWaiters( &pQueue->notEmptyEpoch, &pQueue->popWaiters );
+        }
+    }
+    return pushed;
+}
+
+size_t BlockingQueue_PopBatch( tBlockingQueue* pQueue, void** ppItems, size_t count )
+{
+    unsigned spins = 0;
+
+    while ( TRUE )
+    {
+        BOOL   closed = pQueue->closed;
+        size_t n      = TryPopBatch( pQueue, ppItems, count );
+
+        if ( n == 0 && !closed && ++spins > BLOCKING_SPIN_COUNT )
+        {
+            /* Announce ourselves before the last attempt, so that any push after it is guaranteed to wake us. */
+            InterlockedIncrement( &pQueue->popWaiters );
+            LONG epoch = pQueue->notEmptyEpoch;
+            n = TryPopBatch( pQueue, ppItems, count );
+            if ( n == 0 && !pQueue->closed )
+            {
+                WaitOnAddress( &pQueue->notEmptyEpoch, &epoch, sizeof( epoch ), INFINITE );
+            }
+            InterlockedDecrement( &pQueue->popWaiters );
+            spins = 0;
+        }
+        else if ( n == 0 && !closed )
+        {
+            YieldProcessor();
+        }
+
+        if ( n != 0 )
+        {
+            WakeWaiters( &pQueue->notFullEpoch, &pQueue->pushWaiters );
+            return n;
+        }
+        if ( closed )
+        {
+            /* Closed before the queue was found empty: nothing more will arrive. */
+            return 0;
+        }
+    }
+}
+
+BOOL BlockingQueue_Push( tBlockingQueue* pQueue, void* pData )
+{
+    return BlockingQueue_PushBatch( pQueue, &pData, 1 ) == 1;
+}
+
+BOOL BlockingQueue_Pop( tBlockingQueue* pQueue, void** ppData )
+{
+    return BlockingQueue_PopBatch( pQueue, ppData, 1 ) == 1;
+}
+
+void BlockingQueue_Close( tBlockingQueue* pQueue )
+{
+    InterlockedExchange( &pQueue->closed, TRUE );
+    InterlockedIncrement( &pQueue->notEmptyEpoch );
+    InterlockedIncrement( &pQueue->notFullEpoch );
+    WakeByAddressAll( ( PVOID ) &pQueue->notEmptyEpoch );
+    WakeByAddressAll( ( PVOID ) &pQueue->notFullEpoch );
+}
+
+size_t BlockingQueue_Depth( tBlockingQueue const * pQueue )
+{
+    LONG64 head;
+    LONG64 tail;
+
+    /* Consumer side first, so that a concurrent pop can only make the result too large, never negative. */
+    if ( pQueue->kind == QUEUE_KIND_SPSC )
+    {
+        head = ReadAcquire64( &pQueue->u.spsc.head );
+        tail = ReadAcquire64( &pQueue->u.spsc.tail );
+    }
+    else
+    {
+        head = ReadAcquire64( &pQueue->u.mpmc.dequeuePos );
+        tail = ReadAcquire64( &pQueue->u.mpmc.enqueuePos );
+    }
+    return ( tail > head ) ? ( size_t ) ( tail - head ) : 0;
+}
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+static BOOL IsPowerOfTwo( size_t value )
+{
+    return ( value & ( value - 1 ) ) == 0;
+}
+
+static size_t TryPushBatch( tBlockingQueue* pQueue, void* const * ppItems, size_t count )
+{
+    if ( pQueue->kind == QUEUE_KIND_SPSC )
+    {
+        return SpscQueue_TryPushBatch( &pQueue->u.spsc, ppItems, count );
+    }
+    return MpmcQueue_TryPushBatch( &pQueue->u.mpmc, ppItems, count );
+}
+
+static size_t TryPopBatch( tBlockingQueue* pQueue, void** ppItems, size_t count )
+{
+    switch ( pQueue->kind )
+    {
+        case QUEUE_KIND_SPSC:
+        {
+            return SpscQueue_TryPopBatch( &pQueue->u.spsc, ppItems, count );
+        }
+        case QUEUE_KIND_MPSC:
+        {
+            return MpscQueue_TryPopBatch( &pQueue->u.mpmc, ppItems, count );
+        }
+        default:
+        {
+            return MpmcQueue_TryPopBatch( &pQueue->u.mpmc, ppItems, count );
+        }
+    }
+}
+
+/* Wake sleepers on the other side, if any announced themselves. */
+static void WakeWaiters( volatile LONG* pEpoch, volatile LONG* pWaiters )
+{
+    /* Order the preceding push/pop before reading the waiter count (pairs with the waiter's increment). */
+    MemoryBarrier();
+    if ( *pWaiters != 0 )
+    {
+        InterlockedIncrement( pEpoch );
+        WakeByAddressAll( ( PVOID ) pEpoch );
+    }
+}
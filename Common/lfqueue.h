@@ -0,0 +1,159 @@
+/**
+ **********************************************************************************************************************
+ * @file       lfqueue.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Bounded lock-free queues of pointers, plus blocking wrappers.
+ *
+ * tMpmcQueue is Dmitry Vyukov's bounded MPMC queue: every cell carries a sequence number that tells producers and
+ * consumers whether the cell is free or full for a given lap, so each side only contends on its own position counter.
+ * tMpscQueue is the same queue with a consumer side that needs no compare-exchange. tSpscQueue is a ring with one
+ * index per side and a cached copy of the other side's index, so the fast path touches no shared cache line.
+ *
+ * All queues need a power-of-two capacity. The Try functions never block. tBlockingQueue wraps any of them and sleeps
+ * on WaitOnAddress (the Win32 futex) when the queue is empty or full.
+ **********************************************************************************************************************
+ */
+
+#ifndef LFQUEUE_H
+#define LFQUEUE_H
+
+#include <windows.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Size of a cache line, used to keep producer and consumer state apart. */
+#define LFQUEUE_CACHE_LINE          ( 64 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Cell of an MPMC/MPSC queue. */
+typedef struct sQueueCell
+{
+    volatile LONG64 sequence;       /* Position the cell is free (== pos) or full (== pos + 1) for. */
+    void*           pData;          /* Stored item.                                                  */
+} tQueueCell;
+
+/* Bounded multi-producer, multi-consumer queue. */
+typedef struct __declspec( align( LFQUEUE_CACHE_LINE ) ) sMpmcQueue
+{
+    volatile LONG64 enqueuePos;                                         /* Next position to push to.  */
+    char            pad0[ LFQUEUE_CACHE_LINE - sizeof( LONG64 ) ];
+    volatile LONG64 dequeuePos;                                         /* Next position to pop from. */
+    char            pad1[ LFQUEUE_CACHE_LINE - sizeof( LONG64 ) ];
+    tQueueCell*     pCells;                                             /* Cell array.                */
+    LONG64          mask;                                               /* Capacity - 1.              */
+} tMpmcQueue;
+
+/* Bounded multi-producer, single-consumer queue (same layout, cheaper pop). */
+typedef tMpmcQueue tMpscQueue;
+
+/* Bounded single-producer, single-consumer queue. */
+typedef struct __declspec( align( LFQUEUE_CACHE_LINE ) ) sSpscQueue
+{
+    volatile LONG64 tail;                                               /* Written by producer.       */
+    LONG64          cachedHead;                                         /* Producer's copy of head.   */
+    char            pad0[ LFQUEUE_CACHE_LINE - 2 * sizeof( LONG64 ) ];
+    volatile LONG64 head;                                               /* Written by consumer.       */
+    LONG64          cachedTail;                                         /* Consumer's copy of tail.   */
+    char            pad1[ LFQUEUE_CACHE_LINE - 2 * sizeof( LONG64 ) ];
+    void**          ppItems;                                            /* Item array.                */
+    LONG64          mask;                                               /* Capacity - 1.              */
+} tSpscQueue;
+
+/* Kind of queue wrapped by a blocking queue. */
+typedef enum eQueueKind
+{
+    QUEUE_KIND_SPSC = 0,
+    QUEUE_KIND_MPSC = 1,
+    QUEUE_KIND_MPMC = 2
+} tQueueKind;
+
+/* Blocking wrapper around a lock-free queue. */
+typedef struct __declspec( align( LFQUEUE_CACHE_LINE ) ) sBlockingQueue
+{
+    union
+    {
+        tSpscQueue  spsc;
+        tMpmcQueue  mpmc;                                               /* Also used for MPSC.        */
+    } u;
+    tQueueKind      kind;                                               /* Kind of wrapped queue.     */
+    volatile LONG   closed;                                             /* Set by BlockingQueue_Close. */
+    char            pad0[ LFQUEUE_CACHE_LINE - sizeof( tQueueKind ) - sizeof( LONG ) ];
+    volatile LONG   notEmptyEpoch;                                      /* Bumped to wake consumers.  */
+    volatile LONG   popWaiters;                                         /* Consumers about to sleep.  */
+    char            pad1[ LFQUEUE_CACHE_LINE - 2 * sizeof( LONG ) ];
+    volatile LONG   notFullEpoch;                                       /* Bumped to wake producers.  */
+    volatile LONG   pushWaiters;                                        /* Producers about to sleep.  */
+} tBlockingQueue;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/* MPMC queue. Batch functions move up to count items and return how many were moved. */
+BOOL   MpmcQueue_Init( tMpmcQueue* pQueue, size_t capacity );
+void   MpmcQueue_Destroy( tMpmcQueue* pQueue );
+BOOL   MpmcQueue_TryPush( tMpmcQueue* pQueue, void* pData );
+BOOL   MpmcQueue_TryPop( tMpmcQueue* pQueue, void** ppData );
+size_t MpmcQueue_TryPushBatch( tMpmcQueue* pQueue, void* const * ppItems, size_t count );
+size_t MpmcQueue_TryPopBatch( tMpmcQueue* pQueue, void** ppItems, size_t count );
+
+/* MPSC queue. Pop functions may only be called from one thread at a time. */
+BOOL   MpscQueue_Init( tMpscQueue* pQueue, size_t capacity );
+void   MpscQueue_Destroy( tMpscQueue* pQueue );
+BOOL   MpscQueue_TryPush( tMpscQueue* pQueue, void* pData );
+BOOL   MpscQueue_TryPop( tMpscQueue* pQueue, void** ppData );
+size_t MpscQueue_TryPushBatch( tMpscQueue* pQueue, void* const * ppItems, size_t count );
+size_t MpscQueue_TryPopBatch( tMpscQueue* pQueue, void** ppItems, size_t count );
+
+/* SPSC queue. Push and pop functions may each only be called from one thread at a time. */
+BOOL   SpscQueue_Init( tSpscQueue* pQueue, size_t capacity );
+void   SpscQueue_Destroy( tSpscQueue* pQueue );
+BOOL   SpscQueue_TryPush( tSpscQueue* pQueue, void* pData );
+BOOL   SpscQueue_TryPop( tSpscQueue* pQueue, void** ppData );
+size_t SpscQueue_TryPushBatch( tSpscQueue* pQueue, void* const * ppItems, size_t count );
+size_t SpscQueue_TryPopBatch( tSpscQueue* pQueue, void** ppItems, size_t count );
+
+/* Blocking queue. */
+BOOL   BlockingQueue_Init( tBlockingQueue* pQueue, tQueueKind kind, size_t capacity );
+void   BlockingQueue_Destroy( tBlockingQueue* pQueue );
+
+/* Push all items, sleeping while the queue is full. Returns fewer than count only if the queue was closed. */
+size_t BlockingQueue_PushBatch( tBlockingQueue* pQueue, void* const * ppItems, size_t count );
+
+/* Pop between 1 and count items, sleeping while the queue is empty. Returns 0 once closed and drained. */
+size_t BlockingQueue_PopBatch( tBlockingQueue* pQueue, void** ppItems, size_t count );
+
+/* Single-item versions of the above. */
+BOOL   BlockingQueue_Push( tBlockingQueue* pQueue, void* pData );
+BOOL   BlockingQueue_Pop( tBlockingQueue* pQueue, void** ppData );
+
+/* Refuse further pushes and wake everybody. Items already queued can still be popped. */
+void   BlockingQueue_Close( tBlockingQueue* pQueue );
+
+/* Number of queued items. Only a snapshot while other threads push or pop, for monitoring. */
+size_t BlockingQueue_Depth( tBlockingQueue const * pQueue );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LFQUEUE_H */
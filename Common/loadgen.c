@@ -0,0 +1,352 @@
+/**
+ **********************************************************************************************************************
+ * @file       loadgen.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Calibrated synthetic load for the timer and threading experiments.
+ **********************************************************************************************************************
+ */
+
+#include "loadgen.h"
+#include "timing.h"
+
+#include <malloc.h>
+#include <string.h>
+
+#if defined( _M_X64 ) || defined( _M_IX86 )
+#include <emmintrin.h>
+#define LOADGEN_SSE2                ( 1 )
+#endif
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Alignment of the memory kernel buffers. */
+#define LOADGEN_ALIGNMENT           ( 64 )
+
+/* Doubles per stream array touched by one unit (one cache line each). */
+#define STREAM_UNIT                 ( LOADGEN_ALIGNMENT / sizeof( double ) )
+
+/* Multiply-adds per CPU unit and vector iterations per SIMD unit. */
+#define CPU_UNIT                    ( 16 )
+#define SIMD_UNIT                   ( 8 )
+
+/* Calibration: shortest measured run, and number of runs to take the fastest of. */
+#define CALIBRATION_MIN_NS          ( 2000000 )
+#define CALIBRATION_RUNS            ( 5 )
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static uint64_t RunCpu( tLoadGen* pLoad, uint64_t units );
+static uint64_t RunStream( tLoadGen* pLoad, uint64_t units );
+static uint64_t RunChase( tLoadGen* pLoad, uint64_t units );
+static uint64_t RunSimd( tLoadGen* pLoad, uint64_t units );
+static void     Calibrate( tLoadGen* pLoad );
+static uint32_t XorShift( uint32_t* pState );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Names of kinds, indexed by tLoadKind. */
+static char const * const kindNames[ LOAD_KIND_COUNT ] = { "none", "cpu", "stream", "chase", "simd" };
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+BOOL LoadGen_Init( tLoadGen* pLoad, tLoadKind kind, size_t workingSet )
+{
+    if ( !LoadGen_InitCalibrated( pLoad, kind, workingSet, 0.0 ) )
+    {
+        return FALSE;
+    }
+    Calibrate( pLoad );
+    return TRUE;
+}
+
+BOOL LoadGen_InitCalibrated( tLoadGen* pLoad, tLoadKind kind, size_t workingSet, double nsPerUnit )
+{
+    memset( ( void * ) pLoad, 0, sizeof( *pLoad ) );
+    pLoad->kind       = kind;
+    pLoad->nsPerUnit  = nsPerUnit;
+    pLoad->workingSet = ( workingSet != 0 ) ? workingSet : LOADGEN_DEFAULT_WORKING_SET;
+    pLoad->state      = 1;
+    for ( int i = 0; i < LOADGEN_SIMD_LANES; ++i )
+    {
+        pLoad->simdState[ i ] = ( float ) i;
+    }
+
+    if ( kind == LOAD_KIND_STREAM )
+    {
+        /* Three arrays share the working set. */
+        pLoad->streamLength = pLoad->workingSet / ( 3 * sizeof( double ) ) / STREAM_UNIT * STREAM_UNIT;
+        if ( pLoad->streamLength == 0 )
+        {
+            pLoad->streamLength = STREAM_UNIT;
+        }
+        pLoad->pStream = _aligned_malloc( 3 * pLoad->streamLength * sizeof( double ), LOADGEN_ALIGNMENT );
+        if ( pLoad->pStream == NULL )
+        {
+            return FALSE;
+        }
+        for ( size_t i = 0; i < 3 * pLoad->streamLength; ++i )
+        {
+            pLoad->pStream[ i ] = 1.0;
+        }
+    }
+    else if ( kind == LOAD_KIND_CHASE )
+    {
+        size_t count = pLoad->workingSet / sizeof( tChaseNode );
+        if ( count < 2 )
+        {
+            count = 2;
+        }
+        if ( count > UINT32_MAX )
+        {
+            count = UINT32_MAX;
+        }
+        pLoad->pChase = _aligned_malloc( count * sizeof( tChaseNode ), LOADGEN_ALIGNMENT );
+        if ( pLoad->pChase == NULL )
+        {
+            return FALSE;
+        }
+
+        /* Sattolo's algorithm: a random permutation that is a single cycle through all nodes. */
+        uint32_t seed = 0x9E3779B9;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            pLoad->pChase[ i ].next = ( uint32_t ) i;
+        }
+        for ( size_t i = count - 1; i > 0; --i )
+        {
+            size_t   j   = XorShift( &seed ) % i;
+            uint32_t tmp = pLoad->pChase[ i ].next;
+            pLoad->pChase[ i ].next = pLoad->pChase[ j ].next;
+            pLoad->pChase[ j ].next = tmp;
+        }
+    }
+    else if ( kind >= LOAD_KIND_COUNT )
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void LoadGen_Destroy( tLoadGen* pLoad )
+{
+    _aligned_free( pLoad->pStream );
+    _aligned_free( pLoad->pChase );
+    pLoad->pStream = NULL;
+    pLoad->pChase  = NULL;
+}
+
+uint64_t LoadGen_Run( tLoadGen* pLoad, uint64_t ns )
+{
+    if ( pLoad->nsPerUnit <= 0.0 )
+    {
+        return 0;
+    }
+    return LoadGen_RunUnits( pLoad, ( uint64_t ) ( ( double ) ns / pLoad->nsPerUnit + 0.5 ) );
+}
+
+uint64_t LoadGen_RunUnits( tLoadGen* pLoad, uint64_t units )
+{
+    switch ( pLoad->kind )
+    {
+    case LOAD_KIND_CPU:    return RunCpu( pLoad, units );
+    case LOAD_KIND_STREAM: return RunStream( pLoad, units );
+    case LOAD_KIND_CHASE:  return RunChase( pLoad, units );
+    case LOAD_KIND_SIMD:   return RunSimd( pLoad, units );
+    default:               return 0;
+    }
+}
+
+char const * LoadGen_KindName( tLoadKind kind )
+{
+    return ( kind < LOAD_KIND_COUNT ) ? kindNames[ kind ] : "unknown";
+}
+
+tLoadKind LoadGen_ParseKind( char const * name )
+{
+    for ( int i = 0; i < LOAD_KIND_COUNT; ++i )
+    {
+        if ( strcmp( name, kindNames[ i ] ) == 0 )
+        {
+            return ( tLoadKind ) i;
+        }
+    }
+    return LOAD_KIND_COUNT;
+}
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Find the cost of a unit: grow the run until it is long enough to time, then keep the fastest of a few runs. */
+static void Calibrate( tLoadGen* pLoad )
+{
+    uint64_t units = 64;
+    uint64_t best  = UINT64_MAX;
+
+    if ( pLoad->kind == LOAD_KIND_NONE )
+    {
+        return;
+    }
+
+    /* Fault in and warm the working set. */
+    if ( pLoad->kind == LOAD_KIND_STREAM )
+    {
+        LoadGen_RunUnits( pLoad, pLoad->streamLength / STREAM_UNIT );
+    }
+    else if ( pLoad->kind == LOAD_KIND_CHASE )
+    {
+        LoadGen_RunUnits( pLoad, pLoad->workingSet / sizeof( tChaseNode ) );
+    }
+
+    for ( ;; )
+    {
+        uint64_t start = Timing_Now();
+        LoadGen_RunUnits( pLoad, units );
+        uint64_t ticks = Timing_Now() - start;
+        if ( Timing_TicksToNs( ticks ) >= CALIBRATION_MIN_NS )
+        {
+            best = ticks;
+            break;
+        }
+        units *= 2;
+    }
+    for ( int i = 1; i < CALIBRATION_RUNS; ++i )
+    {
+        uint64_t start = Timing_Now();
+        LoadGen_RunUnits( pLoad, units );
+        uint64_t ticks = Timing_Now() - start;
+        best = min( best, ticks );
+    }
+
+    pLoad->nsPerUnit = Timing_TicksToNs( best ) / ( double ) units;
+}
+
+/*
+ * Dependent multiply-add chain, one unit is CPU_UNIT steps. The xor-shift in every step keeps the compiler from folding
+ * consecutive steps into a single multiply-add (a composition of affine steps is affine, this one is not).
+ */
+static __declspec( noinline ) uint64_t RunCpu( tLoadGen* pLoad, uint64_t units )
+{
+    uint64_t x = pLoad->state;
+
+    for ( uint64_t i = 0; i < units; ++i )
+    {
+        for ( int j = 0; j < CPU_UNIT; ++j )
+        {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+            x ^= x >> 29;
+        }
+    }
+    pLoad->state = x;
+    return x;
+}
+
+/* Triad over the stream arrays, one unit is one cache line of each array. */
+static __declspec( noinline ) uint64_t RunStream( tLoadGen* pLoad, uint64_t units )
+{
+    double*       a   = pLoad->pStream;
+    double const* b   = a + pLoad->streamLength;
+    double const* c   = b + pLoad->streamLength;
+    size_t        pos = pLoad->streamPos;
+
+    for ( uint64_t i = 0; i < units; ++i )
+    {
+        for ( size_t j = pos; j < pos + STREAM_UNIT; ++j )
+        {
+            a[ j ] = b[ j ] + 3.0 * c[ j ];
+        }
+        pos += STREAM_UNIT;
+        if ( pos >= pLoad->streamLength )
+        {
+            pos = 0;
+        }
+    }
+    pLoad->streamPos = pos;
+    return pos;
+}
+
+/* Dependent loads around the chase ring, one unit is one load. */
+static __declspec( noinline ) uint64_t RunChase( tLoadGen* pLoad, uint64_t units )
+{
+    tChaseNode const* pNodes = pLoad->pChase;
+    uint32_t          pos    = pLoad->chasePos;
+
+    for ( uint64_t i = 0; i < units; ++i )
+    {
+        pos = pNodes[ pos ].next;
+    }
+    pLoad->chasePos = pos;
+    return pos;
+}
+
+/* Four independent vector multiply-add chains, one unit is SIMD_UNIT iterations. They converge towards 1.0, so no
+ * denormals or overflow no matter how long they run. */
+static __declspec( noinline ) uint64_t RunSimd( tLoadGen* pLoad, uint64_t units )
+{
+#ifdef LOADGEN_SSE2
+    __m128 const mul  = _mm_set1_ps( 0.999f );
+    __m128 const add  = _mm_set1_ps( 0.001f );
+    __m128       acc0 = _mm_loadu_ps( &pLoad->simdState[ 0 ] );
+    __m128       acc1 = _mm_loadu_ps( &pLoad->simdState[ 4 ] );
+    __m128       acc2 = _mm_loadu_ps( &pLoad->simdState[ 8 ] );
+    __m128       acc3 = _mm_loadu_ps( &pLoad->simdState[ 12 ] );
+
+    for ( uint64_t i = 0; i < units; ++i )
+    {
+        for ( int j = 0; j < SIMD_UNIT; ++j )
+        {
+            acc0 = _mm_add_ps( _mm_mul_ps( acc0, mul ), add );
+            acc1 = _mm_add_ps( _mm_mul_ps( acc1, mul ), add );
+            acc2 = _mm_add_ps( _mm_mul_ps( acc2, mul ), add );
+            acc3 = _mm_add_ps( _mm_mul_ps( acc3, mul ), add );
+        }
+    }
+    _mm_storeu_ps( &pLoad->simdState[ 0 ], acc0 );
+    _mm_storeu_ps( &pLoad->simdState[ 4 ], acc1 );
+    _mm_storeu_ps( &pLoad->simdState[ 8 ], acc2 );
+    _mm_storeu_ps( &pLoad->simdState[ 12 ], acc3 );
+#else
+    for ( uint64_t i = 0; i < units; ++i )
+    {
+        for ( int j = 0; j < SIMD_UNIT; ++j )
+        {
+            for ( int k = 0; k < LOADGEN_SIMD_LANES; ++k )
+            {
+                pLoad->simdState[ k ] = pLoad->simdState[ k ] * 0.999f + 0.001f;
+            }
+        }
+    }
+#endif
+    return ( uint64_t ) ( pLoad->simdState[ 0 ] * 1000.0f );
+}
+
+/* Small PRNG for building the chase ring. */
+static uint32_t XorShift( uint32_t* pState )
+{
+    uint32_t x = *pState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *pState = x;
+    return x;
+}
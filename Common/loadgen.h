@@ -0,0 +1,117 @@
+/**
+ **********************************************************************************************************************
+ * @file       loadgen.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Calibrated synthetic load for the timer and threading experiments.
+ *
+ * A load generator runs one kind of kernel in units of fixed work. The cost of a unit is measured once by
+ * LoadGen_Init(), after which LoadGen_Run() converts a requested duration into a fixed number of units. The amount of
+ * work is therefore the same on every call, and preemption or cache interference shows up as a longer run instead of
+ * being hidden by a spin-until-deadline loop.
+ *
+ * Kinds:
+ *  - cpu:    dependent integer multiply-add/xor-shift chain, no memory traffic.
+ *  - stream: triad a[i] = b[i] + k * c[i] over the working set, bandwidth bound once it exceeds the caches.
+ *  - chase:  dependent loads along a random cyclic permutation of cache lines, latency bound.
+ *  - simd:   independent SSE2 multiply-add chains (scalar fallback on other architectures).
+ **********************************************************************************************************************
+ */
+
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+#include <windows.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Default working set of the memory kernels (bytes). */
+#define LOADGEN_DEFAULT_WORKING_SET     ( 8 * 1024 * 1024 )
+
+/* Number of float lanes in the SIMD kernel state. */
+#define LOADGEN_SIMD_LANES              ( 16 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Kind of load. */
+typedef enum eLoadKind
+{
+    LOAD_KIND_NONE   = 0,
+    LOAD_KIND_CPU    = 1,
+    LOAD_KIND_STREAM = 2,
+    LOAD_KIND_CHASE  = 3,
+    LOAD_KIND_SIMD   = 4,
+    LOAD_KIND_COUNT
+} tLoadKind;
+
+/* Node of the pointer-chasing ring, one per cache line. */
+typedef struct sChaseNode
+{
+    uint32_t next;                  /* Index of next node.      */
+    uint32_t pad[ 15 ];             /* Fill the cache line.     */
+} tChaseNode;
+
+/* Load generator. Each thread needs its own, the kernels keep their position between calls. */
+typedef struct sLoadGen
+{
+    tLoadKind   kind;                           /* Kind of kernel.                          */
+    double      nsPerUnit;                      /* Calibrated cost of one unit.             */
+    size_t      workingSet;                     /* Bytes touched by stream and chase.       */
+    uint64_t    state;                          /* CPU kernel state.                        */
+    double*     pStream;                        /* Stream arrays a, b and c back to back.   */
+    size_t      streamLength;                   /* Doubles per stream array.                */
+    size_t      streamPos;                      /* Next stream index.                       */
+    tChaseNode* pChase;                         /* Chase ring.                              */
+    uint32_t    chasePos;                       /* Current chase node.                      */
+    float       simdState[ LOADGEN_SIMD_LANES ];/* SIMD kernel accumulators.                */
+} tLoadGen;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/*
+ * Allocate buffers and calibrate. workingSet is ignored by cpu and simd, 0 selects the default. Timing_Init() must
+ * have been called. Takes a few tens of milliseconds plus one pass over the working set.
+ */
+BOOL LoadGen_Init( tLoadGen* pLoad, tLoadKind kind, size_t workingSet );
+
+/*
+ * Allocate buffers and take the cost of a unit from an earlier calibration of the same kind and working set, e.g. one
+ * passed down by a parent process, instead of measuring it again. Does not need Timing_Init().
+ */
+BOOL LoadGen_InitCalibrated( tLoadGen* pLoad, tLoadKind kind, size_t workingSet, double nsPerUnit );
+void LoadGen_Destroy( tLoadGen* pLoad );
+
+/* Run about ns nanoseconds worth of work (as calibrated). Returns a value that depends on the work done. */
+uint64_t LoadGen_Run( tLoadGen* pLoad, uint64_t ns );
+
+/* Run a fixed number of units. */
+uint64_t LoadGen_RunUnits( tLoadGen* pLoad, uint64_t units );
+
+/* Name of a kind, and kind by name (LOAD_KIND_COUNT if unknown). */
+char const * LoadGen_KindName( tLoadKind kind );
+tLoadKind    LoadGen_ParseKind( char const * name );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADGEN_H */
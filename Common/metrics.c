@@ -0,0 +1,226 @@
+/**
+ **********************************************************************************************************************
+ * @file       metrics.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Live metrics registry published through a named shared-memory segment.
+ **********************************************************************************************************************
+ */
+
+#include "metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Max length of the full mapping name. */
+#define METRICS_MAPPING_NAME_LEN    ( 128 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Holds data for the metrics "module". */
+typedef struct sMetricsData
+{
+    HANDLE            hMapping;                                 /* Handle to the file mapping.            */
+    tMetricsSegment*  pSegment;                                 /* Mapped view of the segment.            */
+    CRITICAL_SECTION  registerLock;                             /* Serializes registration.               */
+    char              mappingName[ METRICS_MAPPING_NAME_LEN ];  /* Name of the mapping actually created.  */
+} tMetricsData;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static HANDLE CreateSegment( char const * mappingName );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Statically allocated data for "module" metrics. */
+static tMetricsData metricsData;
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+BOOL Metrics_Init( char const * name )
+{
+    memset( ( void * ) &metricsData, 0, sizeof( metricsData ) );
+
+    /* Try the plain name first, fall back to a per-process name if another instance already owns it. */
+    sprintf_s( metricsData.mappingName, sizeof( metricsData.mappingName ), "%s%s", METRICS_MAPPING_PREFIX, name );
+    metricsData.hMapping = CreateSegment( metricsData.mappingName );
+    if ( metricsData.hMapping == NULL )
+    {
+        sprintf_s( metricsData.mappingName, sizeof( metricsData.mappingName ), "%s%s.%lu",
+                   METRICS_MAPPING_PREFIX, name, GetCurrentProcessId() );
+        metricsData.hMapping = CreateSegment( metricsData.mappingName );
+    }
+    if ( metricsData.hMapping == NULL )
+    {
+        printf( "[METRICS] Unable to create shared memory (%d)\n", GetLastError() );
+        return FALSE;
+    }
+
+    metricsData.pSegment = MapViewOfFile(
+        metricsData.hMapping,
+        FILE_MAP_ALL_ACCESS,    /* Read/write access.           */
+        0,                      /* Offset high.                 */
+        0,                      /* Offset low.                  */
+        sizeof( tMetricsSegment )
+    );
+    if ( metricsData.pSegment == NULL )
+    {
+        printf( "[METRICS] Unable to map shared memory (%d)\n", GetLastError() );
+        CloseHandle( metricsData.hMapping );
+        metricsData.hMapping = NULL;
+        return FALSE;
+    }
+
+    InitializeCriticalSection( &metricsData.registerLock );
+
+    /* Pages of a fresh mapping are zeroed, fill in the header and publish it last. */
+    metricsData.pSegment->version   = METRICS_VERSION;
+    metricsData.pSegment->processId = GetCurrentProcessId();
+    MemoryBarrier();
+    metricsData.pSegment->magic     = METRICS_MAGIC;
+
+    printf( "[METRICS] Publishing to %s\n", metricsData.mappingName );
+    return TRUE;
+}
+
+void Metrics_Shutdown( void )
+{
+    if ( metricsData.pSegment == NULL )
+    {
+        return;
+    }
+    UnmapViewOfFile( metricsData.pSegment );
+    CloseHandle( metricsData.hMapping );
+    DeleteCriticalSection( &metricsData.registerLock );
+    metricsData.pSegment = NULL;
+    metricsData.hMapping = NULL;
+}
+
+tMetricId Metrics_Register( char const * name, tMetricType type, char const * help )
+{
+    tMetricsSegment* pSeg = metricsData.pSegment;
+    tMetricId        id   = METRICS_INVALID_ID;
+
+    if ( pSeg == NULL )
+    {
+        return METRICS_INVALID_ID;
+    }
+
+    EnterCriticalSection( &metricsData.registerLock );
+
+    /* Already registered? */
+    for ( LONG i = 0; i < pSeg->numMetrics; ++i )
+    {
+        if ( strcmp( pSeg->metrics[ i ].name, name ) == 0 )
+        {
+            id = ( pSeg->metrics[ i ].type == ( uint32_t ) type ) ? ( tMetricId ) pSeg->metrics[ i ].index
+                                                                  : METRICS_INVALID_ID;
+            LeaveCriticalSection( &metricsData.registerLock );
+            return id;
+        }
+    }
+
+    if ( pSeg->numMetrics < METRICS_MAX_METRICS )
+    {
+        if ( type == METRIC_TYPE_HISTOGRAM && pSeg->numHistograms < METRICS_MAX_HISTOGRAMS )
+        {
+            id = pSeg->numHistograms++;
+        }
+        else if ( type != METRIC_TYPE_HISTOGRAM )
+        {
+            id = pSeg->numValues++;
+        }
+    }
+
+    if ( id == METRICS_INVALID_ID )
+    {
+        printf( "[METRICS] Unable to register %s, registry full.\n", name );
+    }
+    else
+    {
+        /* Fill in descriptor before publishing it to readers. */
+        tMetricDesc* pDesc = &pSeg->metrics[ pSeg->numMetrics ];
+        strncpy_s( pDesc->name, sizeof( pDesc->name ), name, _TRUNCATE );
+        strncpy_s( pDesc->help, sizeof( pDesc->help ), help, _TRUNCATE );
+        pDesc->type  = ( uint32_t ) type;
+        pDesc->index = ( uint32_t ) id;
+        MemoryBarrier();
+        ++pSeg->numMetrics;
+    }
+
+    LeaveCriticalSection( &metricsData.registerLock );
+    return id;
+}
+
+tMetricSlot* Metrics_AcquireSlot( char const * name )
+{
+    tMetricsSegment* pSeg = metricsData.pSegment;
+    LONG             index;
+
+    if ( pSeg == NULL )
+    {
+        return NULL;
+    }
+
+    index = InterlockedIncrement( &pSeg->numSlots ) - 1;
+    if ( index >= METRICS_MAX_SLOTS )
+    {
+        printf( "[METRICS] Unable to acquire slot for %s, all slots taken.\n", name );
+        return NULL;
+    }
+
+    tMetricSlot* pSlot = &pSeg->slots[ index ];
+    pSlot->threadId = GetCurrentThreadId();
+    strncpy_s( pSlot->name, sizeof( pSlot->name ), name, _TRUNCATE );
+    MemoryBarrier();
+    pSlot->inUse = TRUE;
+    return pSlot;
+}
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Create a new pagefile-backed mapping. Returns NULL if it could not be created or already existed. */
+static HANDLE CreateSegment( char const * mappingName )
+{
+    HANDLE hMapping = CreateFileMappingA(
+        INVALID_HANDLE_VALUE,           /* Backed by the paging file.   */
+        NULL,                           /* No security attributes.      */
+        PAGE_READWRITE,                 /* Read/write access.           */
+        0,                              /* Size high.                   */
+        sizeof( tMetricsSegment ),      /* Size low.                    */
+        mappingName                     /* Name of mapping.             */
+    );
+    if ( hMapping != NULL && GetLastError() == ERROR_ALREADY_EXISTS )
+    {
+        CloseHandle( hMapping );
+        return NULL;
+    }
+    return hMapping;
+}
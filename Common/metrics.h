@@ -0,0 +1,204 @@
+/**
+ **********************************************************************************************************************
+ * @file       metrics.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Live metrics registry published through a named shared-memory segment.
+ *
+ * Every thread that wants to publish metrics acquires its own slot. A slot is only ever written by its owning thread,
+ * so the hot-path update functions below are single stores without interlocked operations. The stores are 64-bit
+ * atomic (WriteNoFence64) so that a 32-bit build cannot tear them; on x64 they compile to plain moves. Slots are
+ * cache-line aligned so that no two threads share a line. An external reader (see MetricsDump) maps the same segment read-only
+ * and aggregates the slots whenever it likes, without pausing the process.
+ **********************************************************************************************************************
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <windows.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Size of a cache line, used for slot alignment. */
+#define METRICS_CACHE_LINE          ( 64 )
+
+/* Max number of registered metrics per process. */
+#define METRICS_MAX_METRICS         ( 32 )
+
+/* Max number of registered histograms per process (each also counts as a metric). */
+#define METRICS_MAX_HISTOGRAMS      ( 8 )
+
+/* Max number of per-thread slots per process. */
+#define METRICS_MAX_SLOTS           ( 64 )
+
+/* Number of log2 histogram buckets. Bucket n holds values in [2^(n-1), 2^n), bucket 0 holds 0. */
+#define METRICS_HISTOGRAM_BUCKETS   ( 24 )
+
+/* Max length of metric names, help strings and slot names (including terminator). */
+#define METRICS_NAME_LEN            ( 64 )
+#define METRICS_HELP_LEN            ( 96 )
+#define METRICS_SLOT_NAME_LEN       ( 32 )
+
+/* Segment identification. */
+#define METRICS_MAGIC               ( 0x5352544DUL ) /* "MTRS" */
+#define METRICS_VERSION             ( 1 )
+
+/* Shared-memory name prefix (expanded to ex. Local\Win32ApiTests.Metrics.ThreadingTest) */
+#define METRICS_MAPPING_PREFIX      "Local\\Win32ApiTests.Metrics."
+
+/* Returned by Metrics_Register() on failure. All update functions ignore it. */
+#define METRICS_INVALID_ID          ( -1 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Kind of metric. Gauges are aggregated over slots by summing them. */
+typedef enum eMetricType
+{
+    METRIC_TYPE_COUNTER   = 0,
+    METRIC_TYPE_GAUGE     = 1,
+    METRIC_TYPE_HISTOGRAM = 2
+} tMetricType;
+
+/* Handle to a registered metric: index into tMetricSlot::values, or ::histograms for histograms. */
+typedef int tMetricId;
+
+/* Description of a registered metric. */
+typedef struct sMetricDesc
+{
+    char     name[ METRICS_NAME_LEN ];  /* Prometheus-style metric name.                       */
+    char     help[ METRICS_HELP_LEN ];  /* Help text.                                          */
+    uint32_t type;                      /* One of tMetricType.                                 */
+    uint32_t index;                     /* Index into tMetricSlot::values or ::histograms.     */
+} tMetricDesc;
+
+/* Log2 histogram. */
+typedef struct sMetricHistogram
+{
+    volatile uint64_t count;                                /* Number of observations.  */
+    volatile uint64_t sum;                                  /* Sum of observed values.  */
+    volatile uint64_t buckets[ METRICS_HISTOGRAM_BUCKETS ]; /* Per-bucket counts.       */
+} tMetricHistogram;
+
+/* Per-thread slot. Written only by the owning thread. */
+typedef struct __declspec( align( METRICS_CACHE_LINE ) ) sMetricSlot
+{
+    volatile LONG     inUse;                                  /* Non-zero once the slot is claimed.   */
+    DWORD             threadId;                               /* Win32 ID of owning thread.           */
+    char              name[ METRICS_SLOT_NAME_LEN ];          /* Name of owning thread (or port etc.) */
+    volatile uint64_t values[ METRICS_MAX_METRICS ];          /* Counter/gauge values by metric ID.   */
+    tMetricHistogram  histograms[ METRICS_MAX_HISTOGRAMS ];   /* Histograms by histogram index.       */
+} tMetricSlot;
+
+/* Layout of the shared-memory segment. */
+typedef struct __declspec( align( METRICS_CACHE_LINE ) ) sMetricsSegment
+{
+    volatile uint32_t magic;                            /* METRICS_MAGIC once the segment is initialized. */
+    uint32_t          version;                          /* METRICS_VERSION.                               */
+    DWORD             processId;                        /* ID of publishing process.                      */
+    volatile LONG     numMetrics;                       /* Number of published descriptors.               */
+    LONG              numValues;                        /* Number of registered counters and gauges.      */
+    LONG              numHistograms;                    /* Number of registered histograms.               */
+    volatile LONG     numSlots;                         /* Number of claimed slots.                       */
+    tMetricDesc       metrics[ METRICS_MAX_METRICS ];   /* Metric descriptors.                            */
+    tMetricSlot       slots[ METRICS_MAX_SLOTS ];       /* Per-thread slots.                              */
+} tMetricsSegment;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/* Create and map the metrics segment for this process. Returns FALSE if metrics are unavailable. */
+BOOL Metrics_Init( char const * name );
+
+/* Unmap and close the metrics segment. */
+void Metrics_Shutdown( void );
+
+/* Register a metric (or look up an already registered one by name). Call before the hot path starts. */
+tMetricId Metrics_Register( char const * name, tMetricType type, char const * help );
+
+/* Claim a slot for the calling thread. Returns NULL if metrics are unavailable or all slots are taken. */
+tMetricSlot* Metrics_AcquireSlot( char const * name );
+
+/**
+ **********************************************************************************************************************
+ * Hot-path functions
+ **********************************************************************************************************************
+ */
+
+/* Store a value in a slot. A single 64-bit store, also on x86 where a plain one would be split in two. */
+static __inline void Metrics_Store( volatile uint64_t* pValue, uint64_t value )
+{
+    WriteNoFence64( ( volatile LONG64 * ) pValue, ( LONG64 ) value );
+}
+
+/* Load a value from a slot, without tearing against Metrics_Store(). */
+static __inline uint64_t Metrics_Load( volatile uint64_t const * pValue )
+{
+    return ( uint64_t ) ReadNoFence64( ( volatile LONG64 const * ) pValue );
+}
+
+/* Add to a counter. */
+static __inline void Metrics_CounterAdd( tMetricSlot* pSlot, tMetricId id, uint64_t n )
+{
+    if ( pSlot != NULL && id >= 0 )
+    {
+        Metrics_Store( &pSlot->values[ id ], Metrics_Load( &pSlot->values[ id ] ) + n );
+    }
+}
+
+/* Set a gauge. */
+static __inline void Metrics_GaugeSet( tMetricSlot* pSlot, tMetricId id, uint64_t value )
+{
+    if ( pSlot != NULL && id >= 0 )
+    {
+        Metrics_Store( &pSlot->values[ id ], value );
+    }
+}
+
+/* Bucket index of a histogram value. */
+static __inline unsigned Metrics_HistogramBucket( uint64_t value )
+{
+    unsigned bucket = 0;
+    while ( value != 0 && bucket < METRICS_HISTOGRAM_BUCKETS - 1 )
+    {
+        value >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+/* Record a histogram observation. */
+static __inline void Metrics_HistogramObserve( tMetricSlot* pSlot, tMetricId id, uint64_t value )
+{
+    if ( pSlot != NULL && id >= 0 )
+    {
+        tMetricHistogram*  pHist   = &pSlot->histograms[ id ];
+        volatile uint64_t* pBucket = &pHist->buckets[ Metrics_HistogramBucket( value ) ];
+        Metrics_Store( pBucket, Metrics_Load( pBucket ) + 1 );
+        Metrics_Store( &pHist->sum, Metrics_Load( &pHist->sum ) + value );
+        Metrics_Store( &pHist->count, Metrics_Load( &pHist->count ) + 1 );
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICS_H */
@@ -0,0 +1,281 @@
+/**
+ **********************************************************************************************************************
+ * @file       tickpage.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      System tick published to other processes through a read-only shared-memory page.
+ **********************************************************************************************************************
+ */
+
+#include "tickpage.h"
+#include "timing.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static void EventName( char* pBuffer, size_t size, char const * name, unsigned parity );
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+BOOL TickPage_Create( tTickPublisher* pPublisher, char const * name, uint32_t periodNs, BOOL wake )
+{
+    char eventName[ TICKPAGE_NAME_LEN ];
+
+    memset( ( void * ) pPublisher, 0, sizeof( *pPublisher ) );
+    sprintf_s( pPublisher->mappingName, sizeof( pPublisher->mappingName ), "%s%s", TICKPAGE_MAPPING_PREFIX, name );
+
+    pPublisher->hMapping = CreateFileMappingA(
+        INVALID_HANDLE_VALUE,           /* Backed by the paging file.   */
+        NULL,                           /* No security attributes.      */
+        PAGE_READWRITE,                 /* Read/write access.           */
+        0,                              /* Size high.                   */
+        sizeof( tTickPage ),            /* Size low.                    */
+        pPublisher->mappingName         /* Name of mapping.             */
+    );
+    if ( pPublisher->hMapping != NULL && GetLastError() == ERROR_ALREADY_EXISTS )
+    {
+        printf( "[TICKPAGE] %s already has a publisher\n", pPublisher->mappingName );
+        TickPage_Destroy( pPublisher );
+        return FALSE;
+    }
+    if ( pPublisher->hMapping == NULL )
+    {
+        printf( "[TICKPAGE] Unable to create shared memory (%d)\n", GetLastError() );
+        return FALSE;
+    }
+
+    pPublisher->pPage = MapViewOfFile(
+        pPublisher->hMapping,
+        FILE_MAP_ALL_ACCESS,    /* Read/write access.           */
+        0,                      /* Offset high.                 */
+        0,                      /* Offset low.                  */
+        sizeof( tTickPage )
+    );
+    if ( pPublisher->pPage == NULL )
+    {
+        printf( "[TICKPAGE] Unable to map shared memory (%d)\n", GetLastError() );
+        TickPage_Destroy( pPublisher );
+        return FALSE;
+    }
+
+    for ( unsigned parity = 0; wake && parity < 2; ++parity )
+    {
+        EventName( eventName, sizeof( eventName ), name, parity );
+        pPublisher->hWake[ parity ] = CreateEventA(
+            NULL,       /* No security attributes.   */
+            TRUE,       /* Manual reset.             */
+            FALSE,      /* Initial state FALSE.      */
+            eventName   /* Name of event.            */
+        );
+        if ( pPublisher->hWake[ parity ] == NULL )
+        {
+            printf( "[TICKPAGE] Unable to create wake event (%d)\n", GetLastError() );
+            TickPage_Destroy( pPublisher );
+            return FALSE;
+        }
+    }
+
+    /* Pages of a fresh mapping are zeroed (tick 0, sequence even), fill in the header and publish it last. */
+    pPublisher->pPage->version     = TICKPAGE_VERSION;
+    pPublisher->pPage->processId   = GetCurrentProcessId();
+    pPublisher->pPage->periodNs    = periodNs;
+    pPublisher->pPage->timestampHz = Timing_NsToTicks( 1000000000ULL );
+    pPublisher->pPage->wake        = wake;
+    pPublisher->pPage->timestamp   = ( LONG64 ) Timing_Now();
+    MemoryBarrier();
+    pPublisher->pPage->magic       = TICKPAGE_MAGIC;
+
+    printf( "[TICKPAGE] Publishing to %s\n", pPublisher->mappingName );
+    return TRUE;
+}
+
+void TickPage_Destroy( tTickPublisher* pPublisher )
+{
+    for ( unsigned parity = 0; parity < 2; ++parity )
+    {
+        if ( pPublisher->hWake[ parity ] != NULL )
+        {
+            CloseHandle( pPublisher->hWake[ parity ] );
+            pPublisher->hWake[ parity ] = NULL;
+        }
+    }
+    if ( pPublisher->pPage != NULL )
+    {
+        UnmapViewOfFile( pPublisher->pPage );
+        pPublisher->pPage = NULL;
+    }
+    if ( pPublisher->hMapping != NULL )
+    {
+        CloseHandle( pPublisher->hMapping );
+        pPublisher->hMapping = NULL;
+    }
+}
+
+void TickPage_Publish( tTickPublisher* pPublisher, uint64_t tick )
+{
+    tTickPage* pPage = pPublisher->pPage;
+    FILETIME   systemTime;
+
+    if ( pPage == NULL )
+    {
+        return;
+    }
+
+    /* Take the odd sequence, or leave the page to the publish already under way. */
+    LONG sequence = ReadAcquire( &pPage->sequence );
+    if ( ( sequence & 1 ) != 0 || InterlockedCompareExchange( &pPage->sequence, sequence + 1, sequence ) != sequence )
+    {
+        return;
+    }
+    if ( ( LONG64 ) tick <= pPage->tick )
+    {
+        WriteRelease( &pPage->sequence, sequence );
+        return;
+    }
+
+    /* Subscribers that see this tick wait for the next one; make sure its event is not still set from two ago. */
+    if ( pPublisher->hWake[ 0 ] != NULL )
+    {
+        ResetEvent( pPublisher->hWake[ ( tick + 1 ) & 1 ] );
+    }
+
+    GetSystemTimePreciseAsFileTime( &systemTime );
+    WriteNoFence64( &pPage->tick, ( LONG64 ) tick );
+    WriteNoFence64( &pPage->timestamp, ( LONG64 ) Timing_Now() );
+    WriteNoFence64( &pPage->systemTime, ( ( LONG64 ) systemTime.dwHighDateTime << 32 ) | systemTime.dwLowDateTime );
+    WriteRelease( &pPage->sequence, sequence + 2 );
+
+    if ( pPublisher->hWake[ 0 ] != NULL )
+    {
+        SetEvent( pPublisher->hWake[ tick & 1 ] );
+    }
+}
+
+BOOL TickPage_Open( tTickSubscriber* pSubscriber, char const * name )
+{
+    char mappingName[ TICKPAGE_NAME_LEN ];
+    char eventName[ TICKPAGE_NAME_LEN ];
+
+    memset( ( void * ) pSubscriber, 0, sizeof( *pSubscriber ) );
+    sprintf_s( mappingName, sizeof( mappingName ), "%s%s", TICKPAGE_MAPPING_PREFIX, name );
+
+    pSubscriber->hMapping = OpenFileMappingA( FILE_MAP_READ, FALSE, mappingName );
+    if ( pSubscriber->hMapping == NULL )
+    {
+        printf( "[TICKPAGE] Unable to open %s (%d)\n", mappingName, GetLastError() );
+        return FALSE;
+    }
+    pSubscriber->pPage = MapViewOfFile( pSubscriber->hMapping, FILE_MAP_READ, 0, 0, sizeof( tTickPage ) );
+    if ( pSubscriber->pPage == NULL || pSubscriber->pPage->magic != TICKPAGE_MAGIC ||
+         pSubscriber->pPage->version != TICKPAGE_VERSION )
+    {
+        printf( "[TICKPAGE] %s is not a tick page (%d)\n", mappingName, GetLastError() );
+        TickPage_Close( pSubscriber );
+        return FALSE;
+    }
+
+    for ( unsigned parity = 0; pSubscriber->pPage->wake && parity < 2; ++parity )
+    {
+        EventName( eventName, sizeof( eventName ), name, parity );
+        pSubscriber->hWake[ parity ] = OpenEventA( SYNCHRONIZE, FALSE, eventName );
+        if ( pSubscriber->hWake[ parity ] == NULL )
+        {
+            printf( "[TICKPAGE] Unable to open wake event (%d)\n", GetLastError() );
+            TickPage_Close( pSubscriber );
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+void TickPage_Close( tTickSubscriber* pSubscriber )
+{
+    for ( unsigned parity = 0; parity < 2; ++parity )
+    {
+        if ( pSubscriber->hWake[ parity ] != NULL )
+        {
+            CloseHandle( pSubscriber->hWake[ parity ] );
+            pSubscriber->hWake[ parity ] = NULL;
+        }
+    }
+    if ( pSubscriber->pPage != NULL )
+    {
+        UnmapViewOfFile( ( LPCVOID ) pSubscriber->pPage );
+        pSubscriber->pPage = NULL;
+    }
+    if ( pSubscriber->hMapping != NULL )
+    {
+        CloseHandle( pSubscriber->hMapping );
+        pSubscriber->hMapping = NULL;
+    }
+}
+
+BOOL TickPage_Wait( tTickSubscriber* pSubscriber, uint64_t after, DWORD timeoutMs, tTickSample* pSample )
+{
+    ULONGLONG start = GetTickCount64();
+
+    while ( TRUE )
+    {
+        TickPage_Read( pSubscriber, pSample );
+        if ( pSample->tick > after )
+        {
+            return TRUE;
+        }
+
+        DWORD remaining = INFINITE;
+        if ( timeoutMs != INFINITE )
+        {
+            ULONGLONG elapsed = GetTickCount64() - start;
+            if ( elapsed >= timeoutMs )
+            {
+                return FALSE;
+            }
+            remaining = timeoutMs - ( DWORD ) elapsed;
+        }
+
+        /*
+         * The event for the tick after the one just read was reset before that tick was published, but publishing the
+         * tick after that resets it again. Look at the page once more right before sleeping, so that a subscriber that
+         * comes back after two or more publishes does not sleep on the reset event until yet another tick.
+         */
+        if ( pSubscriber->hWake[ 0 ] != NULL )
+        {
+            HANDLE hWake = pSubscriber->hWake[ ( pSample->tick + 1 ) & 1 ];
+            if ( ( uint64_t ) ReadAcquire64( &pSubscriber->pPage->tick ) != pSample->tick )
+            {
+                continue;
+            }
+            if ( WaitForSingleObject( hWake, remaining ) == WAIT_FAILED )
+            {
+                return FALSE;
+            }
+        }
+        else
+        {
+            SwitchToThread();
+        }
+    }
+}
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Name of the wake event set on ticks of the given parity. */
+static void EventName( char* pBuffer, size_t size, char const * name, unsigned parity )
+{
+    sprintf_s( pBuffer, size, "%s%s.Wake%u", TICKPAGE_MAPPING_PREFIX, name, parity );
+}
@@ -0,0 +1,167 @@
+/**
+ **********************************************************************************************************************
+ * @file       tickpage.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      System tick published to other processes through a read-only shared-memory page.
+ *
+ * One process owns the tick timer and publishes every tick, together with the timestamp it was taken at, into a small
+ * named mapping. Any number of other processes map it read-only and read the current tick with a few plain loads and
+ * no system call, like a vDSO page, instead of each of them running a timer of its own. A sequence counter (seqlock)
+ * lets readers detect and retry a read that overlapped a publish, so the publisher never waits for readers.
+ *
+ * Subscribers that want to sleep until the next tick can use TickPage_Wait(), if the publisher was created with wake
+ * enabled. A Windows futex (WaitOnAddress) only works within a process, so the wake uses a pair of named manual-reset
+ * events: publishing tick t resets the event for t + 1 and then sets the one for t, so a subscriber that has seen t
+ * waits on the event for t + 1 and can never sleep on an event that was set before it looked.
+ *
+ * Timestamps are Timing_Now() ticks of the publisher. The time stamp counter (or QueryPerformanceCounter) is the same
+ * in all processes on a machine, so a subscriber can compare them with its own Timing_Now(); timestampHz converts
+ * them without the subscriber having to calibrate.
+ **********************************************************************************************************************
+ */
+
+#ifndef TICKPAGE_H
+#define TICKPAGE_H
+
+#include <windows.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Name prefix of the shared-memory mapping, followed by the publisher name. */
+#define TICKPAGE_MAPPING_PREFIX     "Local\\Win32ApiTests.TickPage."
+
+/* Identifies a valid page ("TICK"). */
+#define TICKPAGE_MAGIC              ( 0x4B434954UL )
+#define TICKPAGE_VERSION            ( 1 )
+
+/* Size of a cache line, used to keep the header and the tick apart. */
+#define TICKPAGE_CACHE_LINE         ( 64 )
+
+/* Max length of the full mapping and event names. */
+#define TICKPAGE_NAME_LEN           ( 128 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Layout of the shared page. Written by the publisher only. */
+typedef struct __declspec( align( TICKPAGE_CACHE_LINE ) ) sTickPage
+{
+    volatile uint32_t magic;                                            /* TICKPAGE_MAGIC once set up.       */
+    uint32_t          version;                                          /* TICKPAGE_VERSION.                 */
+    DWORD             processId;                                        /* Publisher process.                */
+    uint32_t          periodNs;                                         /* Nominal tick period.              */
+    uint64_t          timestampHz;                                      /* Timestamp ticks per second.       */
+    BOOL              wake;                                             /* Wake events exist.                */
+    char              pad0[ TICKPAGE_CACHE_LINE - 3 * sizeof( uint32_t ) - sizeof( DWORD ) - sizeof( uint64_t ) -
+                            sizeof( BOOL ) ];
+    volatile LONG     sequence;                                         /* Odd while a publish is under way. */
+    LONG              reserved;
+    volatile LONG64   tick;                                             /* Latest tick.                      */
+    volatile LONG64   timestamp;                                        /* Timing_Now() when it was taken.   */
+    volatile LONG64   systemTime;                                       /* UTC FILETIME when it was taken.   */
+    char              pad1[ TICKPAGE_CACHE_LINE - 2 * sizeof( LONG ) - 3 * sizeof( LONG64 ) ];
+} tTickPage;
+
+/* Consistent snapshot of a page. */
+typedef struct sTickSample
+{
+    uint64_t tick;          /* Latest tick.                        */
+    uint64_t timestamp;     /* Timing_Now() when it was taken.     */
+    uint64_t systemTime;    /* UTC FILETIME when it was taken.     */
+} tTickSample;
+
+/* Owner side of a page. */
+typedef struct sTickPublisher
+{
+    HANDLE     hMapping;                            /* Handle to the file mapping.              */
+    tTickPage* pPage;                               /* Read/write view of the page.             */
+    HANDLE     hWake[ 2 ];                          /* Set on even/odd ticks, if wake enabled.  */
+    char       mappingName[ TICKPAGE_NAME_LEN ];    /* Name of the mapping.                     */
+} tTickPublisher;
+
+/* Reader side of a page. */
+typedef struct sTickSubscriber
+{
+    HANDLE            hMapping;     /* Handle to the file mapping.              */
+    tTickPage const * pPage;        /* Read-only view of the page.              */
+    HANDLE            hWake[ 2 ];   /* Set on even/odd ticks, if wake enabled.  */
+} tTickSubscriber;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/*
+ * Create the page of publisher name, at tick 0. Fails if another process already publishes under that name, as there
+ * should only be one owner of a tick. Needs Timing_Init().
+ */
+BOOL TickPage_Create( tTickPublisher* pPublisher, char const * name, uint32_t periodNs, BOOL wake );
+void TickPage_Destroy( tTickPublisher* pPublisher );
+
+/*
+ * Publish a tick, stamped with the current time. Ticks count up from 1 and must not wrap. Cheap enough to call from a
+ * timer callback; with wake enabled it also resets and sets an event. Overlapping calls (e.g. a late timer callback)
+ * do not tear the page: all but one of them are dropped, as is a tick not newer than the published one.
+ */
+void TickPage_Publish( tTickPublisher* pPublisher, uint64_t tick );
+
+/* Map the page of publisher name read-only. Fails if there is none. */
+BOOL TickPage_Open( tTickSubscriber* pSubscriber, char const * name );
+void TickPage_Close( tTickSubscriber* pSubscriber );
+
+/*
+ * Sleep until a tick after the given one is published, or timeoutMs (INFINITE for none) has passed. Returns FALSE on
+ * timeout. Polls with SwitchToThread() if the publisher has no wake events.
+ *
+ * Two publishes between the last read of the page and the start of the wait reset the event it sleeps on again. The
+ * page is read once more right before sleeping, which narrows that to a few instructions; a subscriber preempted
+ * exactly there sleeps until the following tick, which shows up as a missed tick rather than as wake latency.
+ */
+BOOL TickPage_Wait( tTickSubscriber* pSubscriber, uint64_t after, DWORD timeoutMs, tTickSample* pSample );
+
+/**
+ **********************************************************************************************************************
+ * Hot-path functions
+ **********************************************************************************************************************
+ */
+
+/* Read the latest tick. Plain loads only, retried while the publisher is writing. */
+static __inline void TickPage_Read( tTickSubscriber const * pSubscriber, tTickSample* pSample )
+{
+    tTickPage const * pPage = pSubscriber->pPage;
+    LONG              sequence;
+
+    do
+    {
+        while ( ( sequence = ReadAcquire( &pPage->sequence ) ) & 1 )
+        {
+            YieldProcessor();
+        }
+        /* Acquire loads keep the second read of the sequence after the data. */
+        pSample->tick       = ( uint64_t ) ReadAcquire64( &pPage->tick );
+        pSample->timestamp  = ( uint64_t ) ReadAcquire64( &pPage->timestamp );
+        pSample->systemTime = ( uint64_t ) ReadAcquire64( &pPage->systemTime );
+    } while ( ReadAcquire( &pPage->sequence ) != sequence );
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TICKPAGE_H */
@@ -0,0 +1,100 @@
+/**
+ **********************************************************************************************************************
+ * @file       timing.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Cheap high-resolution timestamps and percentile helpers for the benchmarks.
+ **********************************************************************************************************************
+ */
+
+#include "timing.h"
+
+#include <stdlib.h>
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Duration of the calibration interval in milliseconds. */
+#define CALIBRATION_MS              ( 50 )
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static int CompareSamples( void const * pA, void const * pB );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Nanoseconds per timestamp tick. */
+static double nsPerTick = 1.0;
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+void Timing_Init( void )
+{
+    LARGE_INTEGER frequency, qpcStart, qpcEnd;
+    uint64_t      tickStart, tickEnd;
+
+    QueryPerformanceFrequency( &frequency );
+
+    QueryPerformanceCounter( &qpcStart );
+    tickStart = Timing_Now();
+    Sleep( CALIBRATION_MS );
+    QueryPerformanceCounter( &qpcEnd );
+    tickEnd = Timing_Now();
+
+    double elapsedNs = ( double ) ( qpcEnd.QuadPart - qpcStart.QuadPart ) * 1e9 / ( double ) frequency.QuadPart;
+    nsPerTick = elapsedNs / ( double ) ( tickEnd - tickStart );
+}
+
+double Timing_TicksToNs( uint64_t ticks )
+{
+    return ( double ) ticks * nsPerTick;
+}
+
+uint64_t Timing_NsToTicks( uint64_t ns )
+{
+    return ( uint64_t ) ( ( double ) ns / nsPerTick );
+}
+
+void Timing_Sort( uint64_t* pSamples, size_t count )
+{
+    qsort( pSamples, count, sizeof( *pSamples ), CompareSamples );
+}
+
+uint64_t Timing_Percentile( uint64_t const * pSorted, size_t count, double percentile )
+{
+    if ( count == 0 )
+    {
+        return 0;
+    }
+    size_t index = ( size_t ) ( percentile * ( double ) ( count - 1 ) + 0.5 );
+    return pSorted[ index < count ? index : count - 1 ];
+}
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+static int CompareSamples( void const * pA, void const * pB )
+{
+    uint64_t a = *( uint64_t const * ) pA;
+    uint64_t b = *( uint64_t const * ) pB;
+    return ( a > b ) - ( a < b );
+}
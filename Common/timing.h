@@ -0,0 +1,71 @@
+/**
+ **********************************************************************************************************************
+ * @file       timing.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Cheap high-resolution timestamps and percentile helpers for the benchmarks.
+ *
+ * QueryPerformanceCounter typically ticks at 10 MHz, which is too coarse for sub-microsecond latencies. On x86/x64
+ * the (invariant) time stamp counter is used instead and calibrated against QueryPerformanceCounter by Timing_Init().
+ * Other architectures fall back to QueryPerformanceCounter.
+ **********************************************************************************************************************
+ */
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <windows.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined( _M_X64 ) || defined( _M_IX86 )
+#include <intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/* Calibrate the timestamp counter. Blocks for about 50 ms, call once at startup. */
+void Timing_Init( void );
+
+/* Convert between timestamp ticks and nanoseconds. */
+double   Timing_TicksToNs( uint64_t ticks );
+uint64_t Timing_NsToTicks( uint64_t ns );
+
+/* Sort samples in place (ascending). */
+void Timing_Sort( uint64_t* pSamples, size_t count );
+
+/* Value at percentile (0.0 - 1.0) of sorted samples, 0 if there are none. */
+uint64_t Timing_Percentile( uint64_t const * pSorted, size_t count, double percentile );
+
+/**
+ **********************************************************************************************************************
+ * Hot-path functions
+ **********************************************************************************************************************
+ */
+
+/* Current timestamp in ticks. */
+static __inline uint64_t Timing_Now( void )
+{
+#if defined( _M_X64 ) || defined( _M_IX86 )
+    return __rdtsc();
+#else
+    LARGE_INTEGER now;
+    QueryPerformanceCounter( &now );
+    return ( uint64_t ) now.QuadPart;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMING_H */
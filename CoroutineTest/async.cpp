@@ -0,0 +1,338 @@
+/**
+ **********************************************************************************************************************
+ * @file       async.cpp
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Single-threaded C++20 coroutine executor on an I/O completion port.
+ **********************************************************************************************************************
+ */
+
+#include "async.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+
+namespace Async
+{
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Completions dequeued per GetQueuedCompletionStatusEx call. */
+#define COMPLETION_BATCH    ( 64 )
+
+/* Executor running on this thread. */
+static thread_local Executor* pCurrentExecutor = nullptr;
+
+/**
+ **********************************************************************************************************************
+ * Task
+ **********************************************************************************************************************
+ */
+
+Task::promise_type::~promise_type()
+{
+    if ( pExecutor != nullptr )
+    {
+        pExecutor->TaskEnded();
+    }
+}
+
+Task::~Task()
+{
+    /* Never spawned. */
+    if ( handle )
+    {
+        handle.destroy();
+    }
+}
+
+/**
+ **********************************************************************************************************************
+ * Executor
+ **********************************************************************************************************************
+ */
+
+Executor::Executor() : timerSequence( 0 ), liveTasks( 0 )
+{
+    hPort = CreateIoCompletionPort(
+        INVALID_HANDLE_VALUE,   /* New port, no file yet.            */
+        NULL,                   /* No existing port.                 */
+        0,                      /* No completion key.                */
+        1                       /* Only Run() dequeues.              */
+    );
+}
+
+Executor::~Executor()
+{
+    if ( hPort != NULL )
+    {
+        CloseHandle( hPort );
+    }
+}
+
+Executor* Executor::Current()
+{
+    return pCurrentExecutor;
+}
+
+void Executor::Spawn( Task task )
+{
+    std::coroutine_handle<Task::promise_type> h = task.handle;
+
+    task.handle            = nullptr;
+    h.promise().pExecutor  = this;
+    ++liveTasks;
+    ready.push_back( h );
+}
+
+void Executor::AddTimer( uint64_t deadline, std::coroutine_handle<> h )
+{
+    timers.push( Timer{ deadline, timerSequence++, h } );
+}
+
+BOOL Executor::Associate( HANDLE hFile )
+{
+    if ( CreateIoCompletionPort( hFile, hPort, 0, 0 ) == NULL )
+    {
+        return FALSE;
+    }
+
+    /* Operations that complete immediately are resumed inline instead of through the port. */
+    return SetFileCompletionNotificationModes( hFile, FILE_SKIP_COMPLETION_PORT_ON_SUCCESS );
+}
+
+BOOL Executor::Post( IoOperation* pOperation )
+{
+    return PostQueuedCompletionStatus( hPort, 0, 0, &pOperation->overlapped );
+}
+
+void Executor::Run()
+{
+    OVERLAPPED_ENTRY entries[ COMPLETION_BATCH ];
+    Executor*        pPrevious = pCurrentExecutor;
+
+    pCurrentExecutor = this;
+    while ( liveTasks > 0 )
+    {
+        /* Run everything runnable, including coroutines made runnable while doing so. */
+        while ( !ready.empty() )
+        {
+            std::coroutine_handle<> h = ready.front();
+            ready.pop_front();
+            h.resume();
+        }
+        if ( liveTasks == 0 )
+        {
+            break;
+        }
+
+        /* Expired timers. */
+        uint64_t now = Timing_Now();
+        while ( !timers.empty() && timers.top().deadline <= now )
+        {
+            ready.push_back( timers.top().waiter );
+            timers.pop();
+        }
+
+        /* Poll if there is work, otherwise sleep until the next deadline (rounded up to whole ms) or completion. */
+        DWORD timeout = INFINITE;
+        if ( !ready.empty() )
+        {
+            timeout = 0;
+        }
+        else if ( !timers.empty() )
+        {
+            double ns = Timing_TicksToNs( timers.top().deadline - now );
+            timeout   = ( DWORD ) ( ( ns + 999999.0 ) / 1000000.0 );
+        }
+
+        ULONG count = 0;
+        if ( !GetQueuedCompletionStatusEx( hPort, entries, COMPLETION_BATCH, &count, timeout, FALSE ) )
+        {
+            DWORD error = GetLastError();
+            if ( error != WAIT_TIMEOUT )
+            {
+                std::cout << "[ASYNC] GetQueuedCompletionStatusEx failed (" << error << ")" << std::endl;
+                break;
+            }
+            continue;
+        }
+        for ( ULONG i = 0; i < count; ++i )
+        {
+            IoOperation* pOperation = CONTAINING_RECORD( entries[ i ].lpOverlapped, IoOperation, overlapped );
+            ready.push_back( pOperation->waiter );
+        }
+    }
+    pCurrentExecutor = pPrevious;
+}
+
+/**
+ **********************************************************************************************************************
+ * Serial port
+ **********************************************************************************************************************
+ */
+
+BOOL SerialPort::Open( char const * name, DWORD idleTimeoutMs )
+{
+    char path[ 32 ];
+
+    /* "\\.\" prefix needed for COM10 and above. */
+    sprintf_s( path, sizeof( path ), "\\\\.\\%s", name );
+    hPort = CreateFileA(
+        path,
+        GENERIC_READ | GENERIC_WRITE,   /* Read/write access.           */
+        0,                              /* Exclusive access.            */
+        NULL,                           /* No security attributes.      */
+        OPEN_EXISTING,                  /* Ports always exist.          */
+        FILE_FLAG_OVERLAPPED,           /* Completed through the port.  */
+        NULL                            /* No template.                 */
+    );
+    if ( hPort == INVALID_HANDLE_VALUE )
+    {
+        error = GetLastError();
+        return FALSE;
+    }
+
+    /* Return as soon as any byte is available, 0 bytes after the idle timeout. */
+    COMMTIMEOUTS timeouts;
+    ZeroMemory( &timeouts, sizeof( timeouts ) );
+    timeouts.ReadIntervalTimeout        = MAXDWORD;
+    timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+    timeouts.ReadTotalTimeoutConstant   = idleTimeoutMs;
+    if ( !SetCommTimeouts( hPort, &timeouts ) || !Executor::Current()->Associate( hPort ) )
+    {
+        error = GetLastError();
+        Close();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void SerialPort::Close()
+{
+    if ( hPort != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( hPort );
+        hPort = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool SerialPort::ReadAwaiter::await_suspend( std::coroutine_handle<> h )
+{
+    IoOperation* pOperation = &pPort->readOperation;
+
+    ZeroMemory( &pOperation->overlapped, sizeof( pOperation->overlapped ) );
+    pOperation->waiter = h;
+    if ( ReadFile( pPort->hPort, pBuffer, size, &bytesRead, &pOperation->overlapped ) )
+    {
+        /* Completed synchronously, no completion is queued (FILE_SKIP_COMPLETION_PORT_ON_SUCCESS). */
+        pPort->error = ERROR_SUCCESS;
+        return false;
+    }
+
+    pPort->error = GetLastError();
+    return pPort->error == ERROR_IO_PENDING;
+}
+
+DWORD SerialPort::ReadAwaiter::await_resume()
+{
+    if ( pPort->error == ERROR_IO_PENDING )
+    {
+        pPort->error = GetOverlappedResult( pPort->hPort, &pPort->readOperation.overlapped, &bytesRead, FALSE )
+                       ? ERROR_SUCCESS : GetLastError();
+    }
+    return ( pPort->error == ERROR_SUCCESS ) ? bytesRead : 0;
+}
+
+/**
+ **********************************************************************************************************************
+ * Child process
+ **********************************************************************************************************************
+ */
+
+ChildProcess::ChildProcess() : hWait( NULL ), pExecutor( nullptr ), exitOperation()
+{
+    ZeroMemory( &processInfo, sizeof( processInfo ) );
+}
+
+ChildProcess::~ChildProcess()
+{
+    if ( hWait != NULL )
+    {
+        /* Wait for a callback in flight, it still refers to this object. */
+        UnregisterWaitEx( hWait, INVALID_HANDLE_VALUE );
+    }
+    if ( processInfo.hProcess != NULL )
+    {
+        CloseHandle( processInfo.hProcess );
+        CloseHandle( processInfo.hThread );
+    }
+}
+
+BOOL ChildProcess::Start( char const * commandLine )
+{
+    STARTUPINFOA      si;
+    std::vector<char> cmdline( commandLine, commandLine + strlen( commandLine ) + 1 );
+
+    ZeroMemory( &si, sizeof( si ) );
+    si.cb = sizeof( si );
+
+    /* CreateProcess may modify the command line, so it gets a copy of its own (of any length). */
+    return CreateProcessA(
+        NULL,                   // Module name (NULL = use command line)
+        cmdline.data(),         // Command line
+        NULL,                   // Process handle not inheritable
+        NULL,                   // Thread handle not inheritable
+        FALSE,                  // Set handle inheritance to FALSE
+        0,                      // No creation flags
+        NULL,                   // Use parent's environment block
+        NULL,                   // Use parent's starting directory
+        &si,                    // Pointer to STARTUPINFO structure
+        &processInfo            // Pointer to PROCESS_INFORMATION structure
+    );
+}
+
+VOID CALLBACK ChildProcess::OnExit( PVOID pContext, BOOLEAN timedOut )
+{
+    ChildProcess* pChild = static_cast<ChildProcess*>( pContext );
+
+    /* Runs on a thread pool thread, hand the exit over to the executor thread. */
+    pChild->pExecutor->Post( &pChild->exitOperation );
+}
+
+bool ChildProcess::ExitAwaiter::await_suspend( std::coroutine_handle<> h )
+{
+    pChild->pExecutor            = Executor::Current();
+    pChild->exitOperation.waiter = h;
+    return RegisterWaitForSingleObject(
+        &pChild->hWait,
+        pChild->processInfo.hProcess,
+        OnExit,
+        pChild,
+        INFINITE,                                   /* No timeout.                  */
+        WT_EXECUTEONLYONCE | WT_EXECUTEINWAITTHREAD /* Callback only posts.         */
+    ) != FALSE;
+}
+
+DWORD ChildProcess::ExitAwaiter::await_resume()
+{
+    DWORD exitCode = 0;
+
+    if ( pChild->hWait != NULL )
+    {
+        /* The callback is done with this object once it has posted, no need to wait for it. */
+        UnregisterWait( pChild->hWait );
+        pChild->hWait = NULL;
+    }
+    GetExitCodeProcess( pChild->processInfo.hProcess, &exitCode );
+    return exitCode;
+}
+
+} /* namespace Async */
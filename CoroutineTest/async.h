@@ -0,0 +1,244 @@
+/**
+ **********************************************************************************************************************
+ * @file       async.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Single-threaded C++20 coroutine executor on an I/O completion port.
+ *
+ * Tasks are coroutines that suspend on awaitables instead of blocking a thread in WaitForMultipleObjects:
+ *
+ *     co_await Async::SleepUntil( deadline );          // Timer heap, completion port wait timeout.
+ *     DWORD n = co_await port.Read( buffer, size );    // Overlapped ReadFile completed through the port.
+ *     DWORD code = co_await child.Exit();              // Thread pool wait posting to the port.
+ *
+ * One thread calling Executor::Run() drives all tasks spawned on that executor. Timers cost a heap entry and the
+ * coroutine frame, no kernel object and no thread. Deadlines are checked against Timing_Now(), but the port wait rounds
+ * up to whole milliseconds, so timer precision is that of the system timer (see timeBeginPeriod). Awaitables must only
+ * be used from tasks running on an executor.
+ **********************************************************************************************************************
+ */
+
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include <windows.h>
+#include <stdint.h>
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <queue>
+#include <vector>
+
+#include "timing.h"
+
+namespace Async
+{
+
+class Executor;
+
+/**
+ **********************************************************************************************************************
+ * Task
+ **********************************************************************************************************************
+ */
+
+/* Top-level coroutine. Created suspended, started by Executor::Spawn() and destroyed when it returns. */
+class Task
+{
+public:
+    struct promise_type
+    {
+        Executor* pExecutor = nullptr;      /* Executor it was spawned on, told when the task ends. */
+
+        ~promise_type();
+        Task                get_return_object()   { return Task( std::coroutine_handle<promise_type>::from_promise( *this ) ); }
+        std::suspend_always initial_suspend()     { return {}; }
+        std::suspend_never  final_suspend() noexcept { return {}; }
+        void                return_void()         {}
+        void                unhandled_exception() { std::terminate(); }
+    };
+
+    Task( Task&& other ) noexcept : handle( other.handle ) { other.handle = nullptr; }
+    Task( Task const & ) = delete;
+    Task& operator=( Task const & ) = delete;
+    ~Task();
+
+private:
+    friend class Executor;
+    explicit Task( std::coroutine_handle<promise_type> h ) : handle( h ) {}
+
+    std::coroutine_handle<promise_type> handle;     /* Owned until spawned. */
+};
+
+/**
+ **********************************************************************************************************************
+ * Executor
+ **********************************************************************************************************************
+ */
+
+/* Overlapped operation completed through the executor's port. Resumes the waiting coroutine. */
+struct IoOperation
+{
+    OVERLAPPED              overlapped;     /* Must be first, the port hands back its address. */
+    std::coroutine_handle<> waiter;         /* Coroutine to resume on completion.             */
+};
+
+class Executor
+{
+public:
+    Executor();
+    ~Executor();
+
+    /* FALSE if the completion port could not be created. */
+    BOOL IsValid() const { return hPort != NULL; }
+
+    /* Queue a task to start on the next turn of Run(). */
+    void Spawn( Task task );
+
+    /* Run tasks on the calling thread until all of them have returned. */
+    void Run();
+
+    /* Route completions of an overlapped handle to this executor. */
+    BOOL Associate( HANDLE hFile );
+
+    /* Complete an operation from any thread. */
+    BOOL Post( IoOperation* pOperation );
+
+    /* Executor running on the calling thread, nullptr outside Run(). */
+    static Executor* Current();
+
+    /* Used by awaitables. */
+    void AddTimer( uint64_t deadline, std::coroutine_handle<> h );
+    void TaskEnded() { --liveTasks; }
+
+private:
+    struct Timer
+    {
+        uint64_t                deadline;   /* Timing_Now() ticks.                  */
+        uint64_t                sequence;   /* Keeps equal deadlines in order.      */
+        std::coroutine_handle<> waiter;     /* Coroutine to resume.                 */
+
+        bool operator>( Timer const & other ) const
+        {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    HANDLE                                                              hPort;          /* Completion port.       */
+    std::deque<std::coroutine_handle<>>                                 ready;          /* Runnable coroutines.   */
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;         /* Sleeping coroutines.   */
+    uint64_t                                                            timerSequence;  /* Next timer sequence.   */
+    size_t                                                              liveTasks;      /* Spawned, not returned. */
+};
+
+/**
+ **********************************************************************************************************************
+ * Timers
+ **********************************************************************************************************************
+ */
+
+struct SleepAwaiter
+{
+    uint64_t deadline;      /* Timing_Now() ticks. */
+
+    bool await_ready() const { return Timing_Now() >= deadline; }
+    void await_suspend( std::coroutine_handle<> h ) { Executor::Current()->AddTimer( deadline, h ); }
+    void await_resume() {}
+};
+
+/* Suspend until Timing_Now() reaches deadline. */
+inline SleepAwaiter SleepUntil( uint64_t deadline ) { return SleepAwaiter{ deadline }; }
+
+/* Suspend for at least ns nanoseconds. */
+inline SleepAwaiter SleepFor( uint64_t ns ) { return SleepAwaiter{ Timing_Now() + Timing_NsToTicks( ns ) }; }
+
+/**
+ **********************************************************************************************************************
+ * Serial port
+ **********************************************************************************************************************
+ */
+
+/* Serial port opened for overlapped I/O on the current executor. */
+class SerialPort
+{
+public:
+    struct ReadAwaiter
+    {
+        SerialPort* pPort;
+        void*       pBuffer;
+        DWORD       size;
+        DWORD       bytesRead;
+
+        bool  await_ready() { return false; }
+        bool  await_suspend( std::coroutine_handle<> h );
+        DWORD await_resume();
+    };
+
+    SerialPort() : hPort( INVALID_HANDLE_VALUE ), error( ERROR_SUCCESS ) {}
+    ~SerialPort() { Close(); }
+    SerialPort( SerialPort const & ) = delete;
+    SerialPort& operator=( SerialPort const & ) = delete;
+
+    /*
+     * Open a port (e.g. "COM3") on the current executor. A read completes as soon as any byte has arrived, or with 0
+     * bytes after idleTimeoutMs without data.
+     */
+    BOOL Open( char const * name, DWORD idleTimeoutMs );
+    void Close();
+
+    /* co_await to read up to size bytes. Yields the number of bytes read, 0 on timeout or error (see Error()). */
+    ReadAwaiter Read( void* pBuffer, DWORD size ) { return ReadAwaiter{ this, pBuffer, size, 0 }; }
+
+    /* Win32 error of the last read. */
+    DWORD Error() const { return error; }
+
+private:
+    HANDLE      hPort;          /* Port handle.                     */
+    IoOperation readOperation;  /* Outstanding read, at most one.   */
+    DWORD       error;          /* Result of last read.             */
+};
+
+/**
+ **********************************************************************************************************************
+ * Child process
+ **********************************************************************************************************************
+ */
+
+/* Child process whose exit can be awaited. */
+class ChildProcess
+{
+public:
+    struct ExitAwaiter
+    {
+        ChildProcess* pChild;
+
+        bool  await_ready() const { return WaitForSingleObject( pChild->processInfo.hProcess, 0 ) == WAIT_OBJECT_0; }
+        bool  await_suspend( std::coroutine_handle<> h );
+        DWORD await_resume();
+    };
+
+    ChildProcess();
+    ~ChildProcess();
+    ChildProcess( ChildProcess const & ) = delete;
+    ChildProcess& operator=( ChildProcess const & ) = delete;
+
+    /* Start a command line, see CreateProcessA. */
+    BOOL Start( char const * commandLine );
+
+    /* co_await to wait for the process to exit. Yields its exit code. */
+    ExitAwaiter Exit() { return ExitAwaiter{ this }; }
+
+private:
+    static VOID CALLBACK OnExit( PVOID pContext, BOOLEAN timedOut );
+
+    PROCESS_INFORMATION processInfo;    /* Process and thread handles.           */
+    HANDLE              hWait;          /* Thread pool wait while awaited.       */
+    Executor*           pExecutor;      /* Executor to post the exit to.         */
+    IoOperation         exitOperation;  /* Posted when the process exits.        */
+};
+
+} /* namespace Async */
+
+#endif /* ASYNC_H */
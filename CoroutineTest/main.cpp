@@ -0,0 +1,530 @@
+/**
+ **********************************************************************************************************************
+ * @file       main.cpp
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Coroutine executor demo, and timer benchmark against one waitable timer thread per timer.
+ **********************************************************************************************************************
+ */
+
+#include <windows.h>
+#include <psapi.h>
+#include <timeapi.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "async.h"
+#include "timing.h"
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Benchmark defaults. */
+#define DEFAULT_TIMERS          ( 10000 )
+#define DEFAULT_PERIOD_MS       ( 10 )
+#define DEFAULT_DURATION_MS     ( 5000 )
+
+/* Stack reserve of benchmark timer threads (default is 1 MiB). */
+#define TIMER_THREAD_STACK      ( 64 * 1024 )
+
+/* Target resolution of system timer (1ms), applied to both benchmark modes. */
+#define TARGET_RESOLUTION       ( 1 )
+
+/* Demo: ticks printed by the ticker and idle reads before the serial reader gives up. */
+#define DEMO_TICKS              ( 5 )
+#define DEMO_TICK_MS            ( 500 )
+#define DEMO_READ_IDLE_MS       ( 1000 )
+#define DEMO_READ_IDLE_LIMIT    ( 5 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Statistics of one benchmark timer. Padded so timer threads do not share cache lines. */
+typedef struct __declspec( align( 64 ) ) sTimerStats
+{
+    uint64_t first;     /* First deadline.                       */
+    uint64_t ticks;     /* Number of expirations observed.       */
+    uint64_t lateSum;   /* Sum of wake-up lateness (ticks).      */
+    uint64_t lateMax;   /* Worst wake-up lateness (ticks).       */
+} tTimerStats;
+
+/* Process resource usage. */
+typedef struct sUsage
+{
+    SIZE_T   privateBytes;  /* Committed private memory.     */
+    SIZE_T   workingSet;    /* Resident memory.              */
+    DWORD    handles;       /* Open handles.                 */
+    uint64_t cpu100ns;      /* User + kernel time.           */
+    uint64_t now;           /* Timing_Now() of sample.       */
+} tUsage;
+
+/* Holds data for the timer benchmark. */
+typedef struct sBenchData
+{
+    unsigned                 numTimers;     /* Timers per mode.                          */
+    unsigned                 running;       /* Timers that ran in the last mode.        */
+    unsigned                 periodMs;      /* Timer period.                             */
+    uint64_t                 period;        /* Timer period (ticks).                     */
+    uint64_t                 start;         /* Reference time of first deadlines.        */
+    uint64_t                 end;           /* No deadlines after this.                  */
+    HANDLE                   hStartEvent;   /* Releases timer threads.                   */
+    std::vector<tTimerStats> stats;         /* Per timer.                                */
+    tUsage                   peak;          /* Usage sampled halfway through the run.    */
+} tBenchData;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static int          RunDemo( int argc, char** argv );
+static int          RunBench( int argc, char** argv );
+static BOOL         BenchCoroutines( unsigned durationMs );
+static BOOL         BenchThreads( unsigned durationMs );
+static void         Report( char const * mode, tUsage const & before, tUsage const & after );
+static tUsage       SampleUsage( void );
+static void         StartClock( unsigned durationMs );
+static DWORD WINAPI TimerThread( LPVOID pThreadData );
+
+static Async::Task TimerTask( tTimerStats* pStats );
+static Async::Task SampleTask( uint64_t when );
+static Async::Task TickerTask( void );
+static Async::Task SerialReaderTask( char const * portName );
+static Async::Task ChildTask( char const * commandLine );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Statically allocated data for "module" main. */
+static tBenchData benchData;
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+int main( int argc, char *argv[] )
+{
+    Timing_Init();
+
+    if ( argc > 1 && strcmp( argv[ 1 ], "demo" ) == 0 )
+    {
+        return RunDemo( argc - 2, argv + 2 );
+    }
+    if ( argc > 1 && strcmp( argv[ 1 ], "bench" ) == 0 )
+    {
+        return RunBench( argc - 2, argv + 2 );
+    }
+
+    std::cout << "Usage: " << argv[ 0 ] << " demo [-c port] [-e cmdline]" << std::endl;
+    std::cout << "       " << argv[ 0 ] << " bench [-n timers] [-p period_ms] [-d duration_ms] [-m coroutines|threads|both]" << std::endl;
+    return 1;
+}
+
+/**
+ **********************************************************************************************************************
+ * Demo
+ **********************************************************************************************************************
+ */
+
+/* Timers, serial reads and a child process side by side on one thread. */
+static int RunDemo( int argc, char** argv )
+{
+    Async::Executor executor;
+
+    if ( !executor.IsValid() )
+    {
+        std::cout << "Unable to create completion port (" << GetLastError() << ")" << std::endl;
+        return 1;
+    }
+
+    for ( int i = 0; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "-c" ) != 0 && strcmp( argv[ i ], "-e" ) != 0 )
+        {
+            argc = -1;
+        }
+    }
+    if ( argc < 0 || ( argc % 2 ) != 0 )
+    {
+        std::cout << "Usage: demo [-c port] [-e cmdline]" << std::endl;
+        return 1;
+    }
+
+    executor.Spawn( TickerTask() );
+    for ( int i = 0; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "-c" ) == 0 )
+        {
+            executor.Spawn( SerialReaderTask( argv[ i + 1 ] ) );
+        }
+        else if ( strcmp( argv[ i ], "-e" ) == 0 )
+        {
+            executor.Spawn( ChildTask( argv[ i + 1 ] ) );
+        }
+    }
+    executor.Run();
+
+    std::cout << "Goodbye from main!" << std::endl;
+    return 0;
+}
+
+static Async::Task TickerTask( void )
+{
+    uint64_t deadline = Timing_Now();
+
+    for ( int i = 1; i <= DEMO_TICKS; ++i )
+    {
+        deadline += Timing_NsToTicks( DEMO_TICK_MS * 1000000ULL );
+        co_await Async::SleepUntil( deadline );
+        std::cout << "[TICKER] Tick " << i << " (" << Timing_TicksToNs( Timing_Now() - deadline ) / 1000.0
+                  << " us late)" << std::endl;
+    }
+}
+
+static Async::Task SerialReaderTask( char const * portName )
+{
+    Async::SerialPort port;
+    char              buffer[ 256 ];
+    int               idle = 0;
+
+    if ( !port.Open( portName, DEMO_READ_IDLE_MS ) )
+    {
+        std::cout << "[SERIAL " << portName << "] Unable to open (" << port.Error() << ")" << std::endl;
+        co_return;
+    }
+
+    while ( idle < DEMO_READ_IDLE_LIMIT )
+    {
+        DWORD bytesRead = co_await port.Read( buffer, sizeof( buffer ) );
+        if ( port.Error() != ERROR_SUCCESS )
+        {
+            std::cout << "[SERIAL " << portName << "] Read failed (" << port.Error() << ")" << std::endl;
+            break;
+        }
+        idle = ( bytesRead == 0 ) ? idle + 1 : 0;
+        if ( bytesRead != 0 )
+        {
+            std::cout << "[SERIAL " << portName << "] Received " << bytesRead << " bytes" << std::endl;
+        }
+    }
+    std::cout << "[SERIAL " << portName << "] Closing" << std::endl;
+}
+
+static Async::Task ChildTask( char const * commandLine )
+{
+    Async::ChildProcess child;
+
+    if ( !child.Start( commandLine ) )
+    {
+        std::cout << "[CHILD] Process creation failed (" << GetLastError() << ")" << std::endl;
+        co_return;
+    }
+
+    DWORD exitCode = co_await child.Exit();
+    std::cout << "[CHILD] \"" << commandLine << "\" exited with code " << exitCode << std::endl;
+}
+
+/**
+ **********************************************************************************************************************
+ * Benchmark
+ **********************************************************************************************************************
+ */
+
+/* N periodic timers as coroutines on one executor thread versus N threads each blocked on a waitable timer. */
+static int RunBench( int argc, char** argv )
+{
+    unsigned    durationMs = DEFAULT_DURATION_MS;
+    char const* mode       = "both";
+
+    benchData.numTimers = DEFAULT_TIMERS;
+    benchData.periodMs  = DEFAULT_PERIOD_MS;
+    for ( int i = 0; i + 1 < argc; i += 2 )
+    {
+        if      ( strcmp( argv[ i ], "-n" ) == 0 ) benchData.numTimers = ( unsigned ) atoi( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "-p" ) == 0 ) benchData.periodMs  = ( unsigned ) atoi( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "-d" ) == 0 ) durationMs          = ( unsigned ) atoi( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "-m" ) == 0 ) mode                = argv[ i + 1 ];
+        else argc = -1;
+    }
+    if ( argc < 0 || ( argc % 2 ) != 0 ||
+         ( strcmp( mode, "coroutines" ) != 0 && strcmp( mode, "threads" ) != 0 && strcmp( mode, "both" ) != 0 ) )
+    {
+        std::cout << "Usage: bench [-n timers] [-p period_ms] [-d duration_ms] [-m coroutines|threads|both]"
+                  << std::endl;
+        return 1;
+    }
+    if ( benchData.numTimers == 0 || benchData.periodMs == 0 || durationMs == 0 )
+    {
+        std::cout << "Timers, period and duration must be positive." << std::endl;
+        return 1;
+    }
+    benchData.period = Timing_NsToTicks( benchData.periodMs * 1000000ULL );
+
+    /* Same timer resolution for both, otherwise waits round up to the 15.6 ms default. */
+    timeBeginPeriod( TARGET_RESOLUTION );
+
+    std::cout << benchData.numTimers << " timers, " << benchData.periodMs << " ms period, " << durationMs
+              << " ms run" << std::endl << std::endl;
+    std::cout << std::left << std::setw( 12 ) << "mode" << std::right << std::setw( 8 ) << "timers"
+              << std::setw( 13 ) << "private MiB" << std::setw( 8 ) << "WS MiB" << std::setw( 9 ) << "handles"
+              << std::setw( 9 ) << "CPU ms" << std::setw( 8 ) << "CPU %" << std::setw( 11 ) << "ticks"
+              << std::setw( 13 ) << "mean late us" << std::setw( 12 ) << "max late us" << std::endl;
+
+    int result = 0;
+    if ( strcmp( mode, "threads" ) != 0 )
+    {
+        benchData.stats.assign( benchData.numTimers, tTimerStats{} );
+        tUsage before = SampleUsage();
+        if ( BenchCoroutines( durationMs ) )
+        {
+            Report( "coroutines", before, SampleUsage() );
+        }
+        else
+        {
+            result = 1;
+        }
+    }
+    if ( strcmp( mode, "coroutines" ) != 0 )
+    {
+        benchData.stats.assign( benchData.numTimers, tTimerStats{} );
+        tUsage before = SampleUsage();
+        if ( BenchThreads( durationMs ) )
+        {
+            Report( "threads", before, SampleUsage() );
+        }
+        else
+        {
+            result = 1;
+        }
+    }
+
+    timeEndPeriod( TARGET_RESOLUTION );
+    return result;
+}
+
+/* Set the reference time and first deadline of every timer, spread evenly over one period. */
+static void StartClock( unsigned durationMs )
+{
+    benchData.start = Timing_Now();
+    benchData.end   = benchData.start + Timing_NsToTicks( durationMs * 1000000ULL );
+    for ( unsigned i = 0; i < benchData.numTimers; ++i )
+    {
+        benchData.stats[ i ].first = benchData.start + benchData.period + benchData.period * i / benchData.numTimers;
+    }
+}
+
+static BOOL BenchCoroutines( unsigned durationMs )
+{
+    Async::Executor executor;
+
+    if ( !executor.IsValid() )
+    {
+        std::cout << "Unable to create completion port (" << GetLastError() << ")" << std::endl;
+        return FALSE;
+    }
+    StartClock( durationMs );
+    for ( unsigned i = 0; i < benchData.numTimers; ++i )
+    {
+        executor.Spawn( TimerTask( &benchData.stats[ i ] ) );
+    }
+    executor.Spawn( SampleTask( benchData.start + ( benchData.end - benchData.start ) / 2 ) );
+    benchData.running = benchData.numTimers;
+    executor.Run();
+    return TRUE;
+}
+
+static BOOL BenchThreads( unsigned durationMs )
+{
+    std::vector<HANDLE> threads;
+
+    benchData.hStartEvent = CreateEvent(
+        NULL,       /* No security attributes.   */
+        TRUE,       /* Manual reset.             */
+        FALSE,      /* Initial state FALSE.      */
+        NULL        /* No name.                  */
+    );
+    if ( benchData.hStartEvent == NULL )
+    {
+        std::cout << "Unable to create start event (" << GetLastError() << ")" << std::endl;
+        return FALSE;
+    }
+
+    /* Create all threads first, then start the clock so creation time does not eat into the run. */
+    threads.reserve( benchData.numTimers );
+    for ( unsigned i = 0; i < benchData.numTimers; ++i )
+    {
+        HANDLE hThread = CreateThread(
+            NULL,                                   /* No security attributes.   */
+            TIMER_THREAD_STACK,                     /* Stack reserve.            */
+            TimerThread,                            /* Thread function to start. */
+            &benchData.stats[ i ],                  /* Pointer to thread data.   */
+            STACK_SIZE_PARAM_IS_A_RESERVATION,      /* Size is reserve, not commit. */
+            NULL                                    /* No win32 threadid(?).     */
+        );
+        if ( hThread == NULL )
+        {
+            std::cout << "Unable to create thread " << i << " (" << GetLastError() << "), running with " << i
+                      << std::endl;
+            break;
+        }
+        threads.push_back( hThread );
+    }
+    benchData.running = ( unsigned ) threads.size();
+
+    StartClock( durationMs );
+    SetEvent( benchData.hStartEvent );
+
+    /* Sample halfway through, like the coroutine run. */
+    uint64_t half = benchData.start + ( benchData.end - benchData.start ) / 2;
+    uint64_t now  = Timing_Now();
+    if ( half > now )
+    {
+        Sleep( ( DWORD ) ( Timing_TicksToNs( half - now ) / 1000000.0 ) );
+    }
+    benchData.peak = SampleUsage();
+
+    for ( HANDLE hThread : threads )
+    {
+        WaitForSingleObject( hThread, INFINITE );
+        CloseHandle( hThread );
+    }
+    CloseHandle( benchData.hStartEvent );
+    return TRUE;
+}
+
+static Async::Task TimerTask( tTimerStats* pStats )
+{
+    uint64_t deadline = pStats->first;
+
+    while ( deadline <= benchData.end )
+    {
+        co_await Async::SleepUntil( deadline );
+        uint64_t late = Timing_Now() - deadline;
+        pStats->ticks   += 1;
+        pStats->lateSum += late;
+        pStats->lateMax  = ( late > pStats->lateMax ) ? late : pStats->lateMax;
+        deadline        += benchData.period;
+    }
+}
+
+static Async::Task SampleTask( uint64_t when )
+{
+    co_await Async::SleepUntil( when );
+    benchData.peak = SampleUsage();
+}
+
+static DWORD WINAPI TimerThread( LPVOID pThreadData )
+{
+    tTimerStats*  pStats = static_cast<tTimerStats*>( pThreadData );
+    HANDLE        hTimer;
+    LARGE_INTEGER dueTime;
+
+    WaitForSingleObject( benchData.hStartEvent, INFINITE );
+
+    hTimer = CreateWaitableTimer(
+        NULL,           /* No security settings.  */
+        FALSE,          /* Auto reset.            */
+        NULL            /* No timer name.         */
+    );
+    if ( hTimer == NULL )
+    {
+        return 0;
+    }
+
+    /*
+     * One-shot timer re-armed for every deadline, so that it behaves like SleepUntil(): a missed deadline fires at
+     * once and the following ones stay on schedule, where a periodic timer would coalesce the missed signals. Due
+     * times are relative, in 100 ns units rounded up, and the timer is re-armed if it fires early by Timing_Now().
+     */
+    uint64_t deadline = pStats->first;
+    BOOL     ok       = TRUE;
+    while ( deadline <= benchData.end )
+    {
+        uint64_t now;
+        while ( ok && ( now = Timing_Now() ) < deadline )
+        {
+            dueTime.QuadPart = -( LONGLONG ) ( ( Timing_TicksToNs( deadline - now ) + 99.0 ) / 100.0 );
+            ok = SetWaitableTimer( hTimer, &dueTime, 0, NULL, NULL, FALSE ) &&
+                 WaitForSingleObject( hTimer, INFINITE ) == WAIT_OBJECT_0;
+        }
+        if ( !ok )
+        {
+            break;
+        }
+        uint64_t late = Timing_Now() - deadline;
+        pStats->ticks   += 1;
+        pStats->lateSum += late;
+        pStats->lateMax  = ( late > pStats->lateMax ) ? late : pStats->lateMax;
+        deadline        += benchData.period;
+    }
+
+    CloseHandle( hTimer );
+    return 0;
+}
+
+static tUsage SampleUsage( void )
+{
+    PROCESS_MEMORY_COUNTERS_EX memory;
+    FILETIME                   creation, exit, kernel, user;
+    tUsage                     usage;
+
+    ZeroMemory( &usage, sizeof( usage ) );
+    memory.cb = sizeof( memory );
+    if ( GetProcessMemoryInfo( GetCurrentProcess(), ( PROCESS_MEMORY_COUNTERS* ) &memory, sizeof( memory ) ) )
+    {
+        usage.privateBytes = memory.PrivateUsage;
+        usage.workingSet   = memory.WorkingSetSize;
+    }
+    GetProcessHandleCount( GetCurrentProcess(), &usage.handles );
+    if ( GetProcessTimes( GetCurrentProcess(), &creation, &exit, &kernel, &user ) )
+    {
+        usage.cpu100ns = ( ( uint64_t ) kernel.dwHighDateTime << 32 | kernel.dwLowDateTime ) +
+                         ( ( uint64_t ) user.dwHighDateTime << 32 | user.dwLowDateTime );
+    }
+    usage.now = Timing_Now();
+    return usage;
+}
+
+/* Memory and handles are the halfway sample minus the baseline, CPU is for the whole run including setup. */
+static void Report( char const * mode, tUsage const & before, tUsage const & after )
+{
+    uint64_t ticks = 0, lateSum = 0, lateMax = 0;
+
+    for ( tTimerStats const & stats : benchData.stats )
+    {
+        ticks   += stats.ticks;
+        lateSum += stats.lateSum;
+        lateMax  = ( stats.lateMax > lateMax ) ? stats.lateMax : lateMax;
+    }
+
+    double cpuMs  = ( after.cpu100ns - before.cpu100ns ) / 10000.0;
+    double wallMs = Timing_TicksToNs( after.now - before.now ) / 1000000.0;
+    std::cout << std::fixed << std::setprecision( 1 )
+              << std::left << std::setw( 12 ) << mode << std::right << std::setw( 8 ) << benchData.running
+              << std::setw( 13 ) << ( ( double ) benchData.peak.privateBytes - ( double ) before.privateBytes ) / 1048576.0
+              << std::setw( 8 ) << ( ( double ) benchData.peak.workingSet - ( double ) before.workingSet ) / 1048576.0
+              << std::setw( 9 ) << ( long ) benchData.peak.handles - ( long ) before.handles
+              << std::setw( 9 ) << cpuMs
+              << std::setw( 8 ) << cpuMs * 100.0 / wallMs
+              << std::setw( 11 ) << ticks
+              << std::setw( 13 ) << ( ticks ? Timing_TicksToNs( lateSum / ticks ) / 1000.0 : 0.0 )
+              << std::setw( 12 ) << Timing_TicksToNs( lateMax ) / 1000.0 << std::endl;
+}
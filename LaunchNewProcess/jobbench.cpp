@@ -0,0 +1,218 @@
+/**
+ **********************************************************************************************************************
+ * @file       jobbench.cpp
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Job runner benchmark on a synthetic dependency graph, parallel against serial.
+ *
+ * Every job is this executable running a random amount of calibrated CPU load (loadgen.h), so the runs include real
+ * process creation cost, and jobs that share a core take longer instead of still ending on time. Each job depends on
+ * up to a few random jobs among the ones just before it, which gives long chains that keep the critical path well
+ * above the ideal work / slots.
+ **********************************************************************************************************************
+ */
+
+#include <windows.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "jobbench.h"
+#include "jobrunner.h"
+#include "loadgen.h"
+#include "timing.h"
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Defaults. */
+#define DEFAULT_JOBS            ( 1000 )
+#define DEFAULT_MAX_MS          ( 20 )
+#define DEFAULT_MAX_DEPS        ( 3 )
+#define DEFAULT_SEED            ( 1 )
+
+/* Dependencies are picked among this many jobs just before a job. */
+#define DEPENDENCY_WINDOW       ( 64 )
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static void     Generate( tJobGraph& graph, unsigned numJobs, unsigned maxMs, unsigned maxDeps, uint32_t seed,
+                          double nsPerUnit );
+static uint32_t Random( uint32_t* pState );
+static void     PrintRun( char const * mode, unsigned slots, tJobSummary const & summary, double serialMs );
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+int JobBench_Run( int argc, char** argv )
+{
+    unsigned     numJobs  = DEFAULT_JOBS;
+    unsigned     slots    = JobGraph_DefaultSlots();
+    unsigned     maxMs    = DEFAULT_MAX_MS;
+    unsigned     maxDeps  = DEFAULT_MAX_DEPS;
+    uint32_t     seed     = DEFAULT_SEED;
+    char const * fileName = NULL;
+
+    for ( int i = 0; i + 1 < argc; i += 2 )
+    {
+        unsigned value = ( unsigned ) atoi( argv[ i + 1 ] );
+        if      ( strcmp( argv[ i ], "-n" ) == 0 ) numJobs  = value;
+        else if ( strcmp( argv[ i ], "-j" ) == 0 ) slots    = value;
+        else if ( strcmp( argv[ i ], "-w" ) == 0 ) maxMs    = value;
+        else if ( strcmp( argv[ i ], "-d" ) == 0 ) maxDeps  = value;
+        else if ( strcmp( argv[ i ], "-s" ) == 0 ) seed     = value;
+        else if ( strcmp( argv[ i ], "-o" ) == 0 ) fileName = argv[ i + 1 ];
+        else argc = -1;
+    }
+    if ( argc < 0 || ( argc % 2 ) != 0 || numJobs < 1 || slots < 1 || maxMs < 1 )
+    {
+        std::cout << "Usage: LaunchNewProcess bench [-n jobs] [-j slots] [-w max_ms] [-d max_deps] [-s seed] "
+                     "[-o jobfile]" << std::endl;
+        return 1;
+    }
+
+    /* Jobs get the calibration passed down, they are too short to calibrate themselves. */
+    tLoadGen load;
+    std::cout << "[BENCH] Calibrating timer and load..." << std::endl;
+    Timing_Init();
+    if ( !LoadGen_Init( &load, LOAD_KIND_CPU, 0 ) )
+    {
+        std::cout << "[BENCH] Unable to set up load" << std::endl;
+        return 1;
+    }
+    LoadGen_Destroy( &load );
+
+    tJobGraph graph;
+    Generate( graph, numJobs, maxMs, maxDeps, seed, load.nsPerUnit );
+    if ( !JobGraph_Link( graph ) || ( fileName != NULL && !JobGraph_Save( graph, fileName ) ) )
+    {
+        return 1;
+    }
+
+    /* Estimated bounds, from the run times the jobs are told to burn. */
+    double estimatedWork = 0.0;
+    double estimatedPath = 0.0;
+    for ( tJob const & job : graph.jobs )
+    {
+        estimatedWork += job.costMs;
+        estimatedPath  = ( job.priority > estimatedPath ) ? job.priority : estimatedPath;
+    }
+
+    std::cout << std::fixed << std::setprecision( 1 );
+    std::cout << "[BENCH] " << numJobs << " jobs of 1-" << maxMs << " ms, up to " << maxDeps << " dependencies each, "
+              << estimatedWork << " ms of work, " << estimatedPath << " ms critical path (estimated)" << std::endl
+              << std::endl;
+    std::cout << std::left << std::setw( 10 ) << "mode" << std::right << std::setw( 6 ) << "slots"
+              << std::setw( 14 ) << "makespan ms" << std::setw( 12 ) << "work ms" << std::setw( 14 ) << "critical ms"
+              << std::setw( 10 ) << "speedup" << std::setw( 16 ) << "over bound" << std::endl;
+
+    BOOL        ok     = JobGraph_Execute( graph, 1 );
+    tJobSummary serial = JobGraph_Summarize( graph );
+    PrintRun( "serial", 1, serial, serial.makespanMs );
+
+    ok &= JobGraph_Execute( graph, slots );
+    tJobSummary parallel = JobGraph_Summarize( graph );
+    PrintRun( "parallel", slots, parallel, serial.makespanMs );
+
+    if ( !ok )
+    {
+        std::cout << "[BENCH] Some jobs failed" << std::endl;
+    }
+    return ok ? 0 : 1;
+}
+
+int JobBench_Work( int argc, char** argv )
+{
+    tLoadGen load;
+
+    if ( argc < 2 || !LoadGen_InitCalibrated( &load, LOAD_KIND_CPU, 0, atof( argv[ 1 ] ) ) || load.nsPerUnit <= 0.0 )
+    {
+        return 1;
+    }
+
+    LoadGen_Run( &load, ( uint64_t ) atoi( argv[ 0 ] ) * 1000000 );
+    LoadGen_Destroy( &load );
+    return 0;
+}
+
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Random DAG: each job comes after up to maxDeps distinct jobs among the DEPENDENCY_WINDOW before it. */
+static void Generate( tJobGraph& graph, unsigned numJobs, unsigned maxMs, unsigned maxDeps, uint32_t seed,
+                      double nsPerUnit )
+{
+    char     self[ MAX_PATH ];
+    uint32_t state = seed ? seed : 1;
+
+    GetModuleFileNameA( NULL, self, sizeof( self ) );
+    for ( unsigned i = 0; i < numJobs; ++i )
+    {
+        unsigned           ms     = 1 + Random( &state ) % maxMs;
+        unsigned           window = ( i < DEPENDENCY_WINDOW ) ? i : DEPENDENCY_WINDOW;
+        unsigned           deps   = ( window == 0 ) ? 0 : Random( &state ) % ( maxDeps + 1 );
+        std::ostringstream name;
+        std::ostringstream commandLine;
+        std::ostringstream after;
+        std::string        chosen = ",";
+
+        for ( unsigned d = 0; d < deps && d < window; ++d )
+        {
+            std::ostringstream dependency;
+            dependency << "j" << std::setw( 4 ) << std::setfill( '0' ) << i - 1 - Random( &state ) % window;
+            if ( chosen.find( "," + dependency.str() + "," ) == std::string::npos )
+            {
+                chosen += dependency.str() + ",";
+                after << ( after.tellp() > 0 ? "," : "" ) << dependency.str();
+            }
+        }
+        name << "j" << std::setw( 4 ) << std::setfill( '0' ) << i;
+        commandLine << "\"" << self << "\" work " << ms << " " << std::setprecision( 9 ) << nsPerUnit;
+        JobGraph_Add( graph, name.str(), commandLine.str(), 1, ( double ) ms, after.str() );
+    }
+}
+
+/* xorshift32. */
+static uint32_t Random( uint32_t* pState )
+{
+    uint32_t x = *pState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *pState = x;
+    return x;
+}
+
+/* One line of results. "over bound" is how far the makespan is above max( critical path, work / slots ). */
+static void PrintRun( char const * mode, unsigned slots, tJobSummary const & summary, double serialMs )
+{
+    double bound = summary.workMs / slots;
+
+    bound = ( summary.criticalMs > bound ) ? summary.criticalMs : bound;
+    std::cout << std::left << std::setw( 10 ) << mode << std::right << std::setw( 6 ) << slots
+              << std::setw( 14 ) << summary.makespanMs << std::setw( 12 ) << summary.workMs
+              << std::setw( 14 ) << summary.criticalMs << std::setw( 9 ) << std::setprecision( 2 )
+              << ( summary.makespanMs > 0.0 ? serialMs / summary.makespanMs : 0.0 ) << "x"
+              << std::setw( 15 ) << std::setprecision( 1 )
+              << ( bound > 0.0 ? 100.0 * ( summary.makespanMs - bound ) / bound : 0.0 ) << "%" << std::endl;
+}
@@ -0,0 +1,40 @@
+/**
+ **********************************************************************************************************************
+ * @file       jobbench.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Job runner benchmark on a synthetic dependency graph, parallel against serial.
+ **********************************************************************************************************************
+ */
+
+#ifndef JOBBENCH_H
+#define JOBBENCH_H
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/*
+ * Generate a random DAG of jobs that each run "LaunchNewProcess work ms ns_per_unit", run it serially and with the
+ * concurrency limit, and compare makespans. Arguments (after "bench" on the command line):
+ *   -n jobs          Number of jobs (default 1000).
+ *   -j slots         Concurrency limit of the parallel run (default: logical processors).
+ *   -w ms            Max run time of a job, run times are uniform in [1, ms] (default 20).
+ *   -d deps          Max dependencies per job (default 3).
+ *   -s seed          Seed of the graph (default 1).
+ *   -o file          Also write the graph as a job file.
+ * Returns process exit code.
+ */
+int JobBench_Run( int argc, char** argv );
+
+/*
+ * The job of the benchmark graph: run argv[ 0 ] milliseconds worth of CPU load, as calibrated by the benchmark, which
+ * passes the cost of a load unit in argv[ 1 ] so that short jobs do not spend their time calibrating. The amount of
+ * work is fixed, so a job that is preempted or shares a core takes longer. Returns process exit code.
+ */
+int JobBench_Work( int argc, char** argv );
+
+#endif /* JOBBENCH_H */
@@ -0,0 +1,682 @@
+/**
+ **********************************************************************************************************************
+ * @file       jobrunner.cpp
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Parallel runner of child processes with dependencies and a concurrency limit.
+ *
+ * The runner thread sleeps in GetQueuedCompletionStatus. Each child process has a thread pool wait that posts the
+ * job's index to the port when it exits, so the number of running jobs is not limited to MAXIMUM_WAIT_OBJECTS.
+ **********************************************************************************************************************
+ */
+
+#include <windows.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <sstream>
+
+#include "jobrunner.h"
+#include "timing.h"
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Max jobs of the critical path printed by name. */
+#define MAX_PATH_NAMES          ( 8 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Ready job, highest priority first and in the order added among equals. */
+typedef struct sReadyJob
+{
+    double priority;    /* Priority of job.   */
+    size_t index;       /* Index of job.      */
+
+    bool operator<( sReadyJob const & other ) const
+    {
+        return priority != other.priority ? priority < other.priority : index > other.index;
+    }
+} tReadyJob;
+
+/* Holds data for the runner "module". */
+typedef struct sRunnerData
+{
+    HANDLE                         hPort;   /* Completion port receiving job exits.     */
+    std::priority_queue<tReadyJob> ready;   /* Jobs whose dependencies have succeeded.  */
+    size_t                         done;    /* Jobs succeeded, failed or skipped.        */
+} tRunnerData;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static BOOL          StartJob( tJobGraph& graph, size_t index );
+static void          FinishJob( tJobGraph& graph, size_t index, tJobState state );
+static void          AbandonJob( tJobGraph& graph, size_t index );
+static void          SkipJob( tJobGraph& graph, size_t index );
+static std::string   Trim( std::string const & text );
+static double        DurationMs( tJob const & job );
+static char const *  StateName( tJob const & job );
+static VOID CALLBACK OnExit( PVOID pContext, BOOLEAN timedOut );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Statically allocated data for "module" runner. */
+static tRunnerData runnerData;
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+int JobRunner_Run( int argc, char** argv )
+{
+    char const * fileName = NULL;
+    unsigned     slots    = JobGraph_DefaultSlots();
+    bool         perJob   = true;
+
+    for ( int i = 0; i < argc; ++i )
+    {
+        if      ( strcmp( argv[ i ], "-j" ) == 0 && i + 1 < argc ) slots    = ( unsigned ) atoi( argv[ ++i ] );
+        else if ( strcmp( argv[ i ], "-q" ) == 0 && i + 1 < argc ) perJob   = ( atoi( argv[ ++i ] ) == 0 );
+        else if ( argv[ i ][ 0 ] != '-' && fileName == NULL )      fileName = argv[ i ];
+        else slots = 0;
+    }
+    if ( fileName == NULL || slots == 0 )
+    {
+        std::cout << "Usage: LaunchNewProcess run jobfile [-j slots] [-q 1]" << std::endl;
+        std::cout << "  -j slots  Slots shared by running jobs (default one per logical processor)." << std::endl;
+        std::cout << "  -q 1      Quiet: print only the summary, not the timing of every job." << std::endl;
+        std::cout << "Job file lines: name [weight=slots] [cost=ms] [after=name,name...] : command line" << std::endl;
+        return 1;
+    }
+
+    tJobGraph graph;
+    if ( !JobGraph_Load( graph, fileName ) || !JobGraph_Link( graph ) )
+    {
+        return 1;
+    }
+
+    Timing_Init();
+    std::cout << "[RUNNER] " << graph.jobs.size() << " jobs, " << slots << " slots" << std::endl;
+    BOOL ok = JobGraph_Execute( graph, slots );
+    JobGraph_Report( graph, perJob );
+    return ok ? 0 : 1;
+}
+
+void JobGraph_Add( tJobGraph& graph, std::string const & name, std::string const & commandLine, unsigned weight,
+                   double costMs, std::string const & after )
+{
+    tJob job = {};
+
+    job.name        = name;
+    job.commandLine = commandLine;
+    job.weight      = weight;
+    job.costMs      = costMs;
+    job.state       = JOB_STATE_WAITING;
+
+    std::istringstream names( after );
+    std::string        dependency;
+    while ( std::getline( names, dependency, ',' ) )
+    {
+        if ( !dependency.empty() )
+        {
+            job.after.push_back( dependency );
+        }
+    }
+    graph.jobs.push_back( job );
+}
+
+BOOL JobGraph_Load( tJobGraph& graph, char const * fileName )
+{
+    std::ifstream file( fileName );
+    std::string   line;
+    unsigned      lineNumber = 0;
+
+    if ( !file )
+    {
+        std::cout << "[RUNNER] Unable to open " << fileName << std::endl;
+        return FALSE;
+    }
+
+    while ( std::getline( file, line ) )
+    {
+        ++lineNumber;
+        line = Trim( line );
+        if ( line.empty() || line[ 0 ] == '#' )
+        {
+            continue;
+        }
+
+        /* Names and options cannot contain ':', command lines can. */
+        size_t colon = line.find( ':' );
+        if ( colon == std::string::npos || Trim( line.substr( colon + 1 ) ).empty() )
+        {
+            std::cout << fileName << "(" << lineNumber << "): expected 'name [options] : command line'" << std::endl;
+            return FALSE;
+        }
+
+        std::istringstream head( line.substr( 0, colon ) );
+        std::string        name;
+        std::string        option;
+        std::string        after;
+        unsigned           weight = 1;
+        double             costMs = 1.0;
+
+        head >> name;
+        while ( head >> option )
+        {
+            if      ( option.compare( 0, 7, "weight=" ) == 0 ) weight = ( unsigned ) atoi( option.c_str() + 7 );
+            else if ( option.compare( 0, 5, "cost=" ) == 0 )   costMs = atof( option.c_str() + 5 );
+            else if ( option.compare( 0, 6, "after=" ) == 0 )  after  = option.substr( 6 );
+            else
+            {
+                std::cout << fileName << "(" << lineNumber << "): unknown option '" << option << "'" << std::endl;
+                return FALSE;
+            }
+        }
+        if ( name.empty() || weight == 0 || costMs < 0.0 )
+        {
+            std::cout << fileName << "(" << lineNumber << "): missing name, or bad weight or cost" << std::endl;
+            return FALSE;
+        }
+        JobGraph_Add( graph, name, Trim( line.substr( colon + 1 ) ), weight, costMs, after );
+    }
+    return TRUE;
+}
+
+BOOL JobGraph_Save( tJobGraph const & graph, char const * fileName )
+{
+    std::ofstream file( fileName );
+
+    if ( !file )
+    {
+        std::cout << "[RUNNER] Unable to create " << fileName << std::endl;
+        return FALSE;
+    }
+
+    file << "# name [weight=slots] [cost=ms] [after=name,name...] : command line" << std::endl;
+    for ( tJob const & job : graph.jobs )
+    {
+        file << job.name << " weight=" << job.weight << " cost=" << job.costMs;
+        for ( size_t i = 0; i < job.after.size(); ++i )
+        {
+            file << ( i == 0 ? " after=" : "," ) << job.after[ i ];
+        }
+        file << " : " << job.commandLine << std::endl;
+    }
+    return file.good() ? TRUE : FALSE;
+}
+
+BOOL JobGraph_Link( tJobGraph& graph )
+{
+    std::map<std::string, size_t> indexes;
+    std::vector<size_t>           inDegree( graph.jobs.size() );
+
+    for ( size_t i = 0; i < graph.jobs.size(); ++i )
+    {
+        if ( !indexes.insert( std::make_pair( graph.jobs[ i ].name, i ) ).second )
+        {
+            std::cout << "[RUNNER] Job '" << graph.jobs[ i ].name << "' is defined twice" << std::endl;
+            return FALSE;
+        }
+        graph.jobs[ i ].dependencies.clear();
+        graph.jobs[ i ].dependents.clear();
+    }
+
+    for ( size_t i = 0; i < graph.jobs.size(); ++i )
+    {
+        for ( std::string const & name : graph.jobs[ i ].after )
+        {
+            auto it = indexes.find( name );
+            if ( it == indexes.end() )
+            {
+                std::cout << "[RUNNER] Job '" << graph.jobs[ i ].name << "' comes after unknown job '" << name << "'"
+                          << std::endl;
+                return FALSE;
+            }
+            graph.jobs[ i ].dependencies.push_back( it->second );
+            graph.jobs[ it->second ].dependents.push_back( i );
+        }
+        inDegree[ i ] = graph.jobs[ i ].dependencies.size();
+    }
+
+    /* Kahn's algorithm: whatever is never released is on or behind a cycle. */
+    graph.order.clear();
+    for ( size_t i = 0; i < graph.jobs.size(); ++i )
+    {
+        if ( inDegree[ i ] == 0 )
+        {
+            graph.order.push_back( i );
+        }
+    }
+    for ( size_t o = 0; o < graph.order.size(); ++o )
+    {
+        for ( size_t dependent : graph.jobs[ graph.order[ o ] ].dependents )
+        {
+            if ( --inDegree[ dependent ] == 0 )
+            {
+                graph.order.push_back( dependent );
+            }
+        }
+    }
+    if ( graph.order.size() != graph.jobs.size() )
+    {
+        std::cout << "[RUNNER] Dependency cycle among:";
+        for ( size_t i = 0; i < graph.jobs.size(); ++i )
+        {
+            if ( inDegree[ i ] != 0 )
+            {
+                std::cout << " " << graph.jobs[ i ].name;
+            }
+        }
+        std::cout << std::endl;
+        return FALSE;
+    }
+
+    /* Priority: estimated cost of the longest chain starting at the job. */
+    for ( size_t o = graph.order.size(); o-- > 0; )
+    {
+        tJob&  job     = graph.jobs[ graph.order[ o ] ];
+        double longest = 0.0;
+        for ( size_t dependent : job.dependents )
+        {
+            longest = ( graph.jobs[ dependent ].priority > longest ) ? graph.jobs[ dependent ].priority : longest;
+        }
+        job.priority = job.costMs + longest;
+    }
+    return TRUE;
+}
+
+BOOL JobGraph_Execute( tJobGraph& graph, unsigned slots )
+{
+    unsigned freeSlots = slots;
+    unsigned running   = 0;
+
+    runnerData.hPort = CreateIoCompletionPort( INVALID_HANDLE_VALUE, NULL, 0, 1 );
+    if ( runnerData.hPort == NULL )
+    {
+        std::cout << "[RUNNER] Unable to create completion port (" << GetLastError() << ")" << std::endl;
+        return FALSE;
+    }
+    runnerData.ready = std::priority_queue<tReadyJob>();
+    runnerData.done  = 0;
+
+    for ( size_t i = 0; i < graph.jobs.size(); ++i )
+    {
+        tJob& job     = graph.jobs[ i ];
+        job.remaining = ( unsigned ) job.dependencies.size();
+        job.state     = JOB_STATE_WAITING;
+        job.hProcess  = NULL;
+        job.hWait     = NULL;
+        job.exitCode  = 0;
+        job.start     = 0;
+        job.end       = 0;
+        if ( job.remaining == 0 )
+        {
+            job.state = JOB_STATE_READY;
+            runnerData.ready.push( tReadyJob{ job.priority, i } );
+        }
+    }
+
+    while ( runnerData.done < graph.jobs.size() )
+    {
+        /*
+         * Start ready jobs in priority order. One that does not fit the free slots is passed over for now, so that
+         * lighter jobs behind it still fill them, and goes back to the queue afterwards. A job heavier than the limit
+         * runs alone.
+         */
+        std::vector<tReadyJob> passedOver;
+        while ( !runnerData.ready.empty() && freeSlots > 0 )
+        {
+            tReadyJob ready  = runnerData.ready.top();
+            unsigned  weight = ( graph.jobs[ ready.index ].weight < slots ) ? graph.jobs[ ready.index ].weight : slots;
+            size_t    index  = ready.index;
+            runnerData.ready.pop();
+            if ( weight > freeSlots )
+            {
+                passedOver.push_back( ready );
+                continue;
+            }
+            if ( StartJob( graph, index ) )
+            {
+                freeSlots -= weight;
+                ++running;
+            }
+            else
+            {
+                FinishJob( graph, index, JOB_STATE_FAILED );
+            }
+        }
+        for ( tReadyJob const & ready : passedOver )
+        {
+            runnerData.ready.push( ready );
+        }
+        if ( running == 0 )
+        {
+            break;
+        }
+
+        DWORD        bytes;
+        ULONG_PTR    key;
+        LPOVERLAPPED pOverlapped;
+        if ( !GetQueuedCompletionStatus( runnerData.hPort, &bytes, &key, &pOverlapped, INFINITE ) )
+        {
+            std::cout << "[RUNNER] Unable to wait for jobs (" << GetLastError() << ")" << std::endl;
+            break;
+        }
+
+        tJob& job = graph.jobs[ key ];
+        job.end   = Timing_Now();
+        UnregisterWaitEx( job.hWait, INVALID_HANDLE_VALUE );
+        GetExitCodeProcess( job.hProcess, &job.exitCode );
+        CloseHandle( job.hProcess );
+        job.hProcess = NULL;
+        job.hWait    = NULL;
+        freeSlots += ( job.weight < slots ) ? job.weight : slots;
+        --running;
+        FinishJob( graph, ( size_t ) key, ( job.exitCode == 0 ) ? JOB_STATE_SUCCEEDED : JOB_STATE_FAILED );
+    }
+
+    /* Jobs are only left running if waiting failed. Their callbacks must be gone before the port is closed. */
+    for ( size_t i = 0; i < graph.jobs.size(); ++i )
+    {
+        if ( graph.jobs[ i ].state == JOB_STATE_RUNNING )
+        {
+            AbandonJob( graph, i );
+        }
+    }
+    CloseHandle( runnerData.hPort );
+    runnerData.hPort = NULL;
+    return ( runnerData.done == graph.jobs.size() && JobGraph_Summarize( graph ).succeeded == graph.jobs.size() );
+}
+
+tJobSummary JobGraph_Summarize( tJobGraph const & graph )
+{
+    tJobSummary         summary = {};
+    std::vector<double> pathMs( graph.jobs.size(), 0.0 );
+    std::vector<size_t> previous( graph.jobs.size(), SIZE_MAX );
+    uint64_t            first   = UINT64_MAX;
+    uint64_t            last    = 0;
+    size_t              tail    = SIZE_MAX;
+
+    for ( size_t index : graph.order )
+    {
+        tJob const & job = graph.jobs[ index ];
+
+        summary.succeeded += ( job.state == JOB_STATE_SUCCEEDED ) ? 1 : 0;
+        summary.failed    += ( job.state == JOB_STATE_FAILED ) ? 1 : 0;
+        summary.skipped   += ( job.state == JOB_STATE_SKIPPED ) ? 1 : 0;
+        if ( job.start != 0 )
+        {
+            first = ( job.start < first ) ? job.start : first;
+            last  = ( job.end > last ) ? job.end : last;
+        }
+        summary.workMs += DurationMs( job );
+
+        /* Longest chain by measured run time ending in this job. */
+        for ( size_t dependency : job.dependencies )
+        {
+            if ( pathMs[ dependency ] > pathMs[ index ] || previous[ index ] == SIZE_MAX )
+            {
+                pathMs[ index ]   = pathMs[ dependency ];
+                previous[ index ] = dependency;
+            }
+        }
+        pathMs[ index ] += DurationMs( job );
+        if ( tail == SIZE_MAX || pathMs[ index ] > pathMs[ tail ] )
+        {
+            tail = index;
+        }
+    }
+
+    summary.makespanMs = ( last > first ) ? Timing_TicksToNs( last - first ) / 1e6 : 0.0;
+    if ( tail != SIZE_MAX )
+    {
+        summary.criticalMs = pathMs[ tail ];
+        for ( size_t index = tail; index != SIZE_MAX; index = previous[ index ] )
+        {
+            summary.criticalPath.push_back( index );
+        }
+        std::reverse( summary.criticalPath.begin(), summary.criticalPath.end() );
+    }
+    return summary;
+}
+
+void JobGraph_Report( tJobGraph const & graph, bool perJob )
+{
+    tJobSummary summary = JobGraph_Summarize( graph );
+    uint64_t    first   = UINT64_MAX;
+
+    for ( tJob const & job : graph.jobs )
+    {
+        first = ( job.start != 0 && job.start < first ) ? job.start : first;
+    }
+
+    std::cout << std::fixed << std::setprecision( 1 );
+    if ( perJob )
+    {
+        std::vector<size_t> byStart( graph.order );
+        std::stable_sort( byStart.begin(), byStart.end(), [ &graph ]( size_t a, size_t b )
+        {
+            /* Jobs that never started go last. */
+            return ( graph.jobs[ a ].start - 1 ) < ( graph.jobs[ b ].start - 1 );
+        } );
+
+        std::cout << std::endl << std::left << std::setw( 24 ) << "job" << std::right << std::setw( 7 ) << "weight"
+                  << std::setw( 12 ) << "start ms" << std::setw( 12 ) << "end ms" << std::setw( 12 ) << "ms" << "  "
+                  << "result" << std::endl;
+        for ( size_t index : byStart )
+        {
+            tJob const & job = graph.jobs[ index ];
+            std::cout << std::left << std::setw( 24 ) << job.name << std::right << std::setw( 7 ) << job.weight;
+            if ( job.start != 0 )
+            {
+                std::cout << std::setw( 12 ) << Timing_TicksToNs( job.start - first ) / 1e6
+                          << std::setw( 12 ) << Timing_TicksToNs( job.end - first ) / 1e6
+                          << std::setw( 12 ) << DurationMs( job );
+            }
+            else
+            {
+                std::cout << std::setw( 12 ) << "-" << std::setw( 12 ) << "-" << std::setw( 12 ) << "-";
+            }
+            std::cout << "  " << StateName( job );
+            if ( job.state == JOB_STATE_FAILED )
+            {
+                std::cout << " (" << job.exitCode << ")";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "[RUNNER] " << summary.succeeded << " succeeded, " << summary.failed << " failed, "
+              << summary.skipped << " skipped" << std::endl;
+    std::cout << "[RUNNER] Makespan      " << std::setw( 10 ) << summary.makespanMs << " ms" << std::endl;
+    std::cout << "[RUNNER] Work          " << std::setw( 10 ) << summary.workMs << " ms (speedup "
+              << std::setprecision( 2 ) << ( summary.makespanMs > 0.0 ? summary.workMs / summary.makespanMs : 0.0 )
+              << std::setprecision( 1 ) << ")" << std::endl;
+    std::cout << "[RUNNER] Critical path " << std::setw( 10 ) << summary.criticalMs << " ms over "
+              << summary.criticalPath.size() << " jobs:";
+    for ( size_t i = 0; i < summary.criticalPath.size(); ++i )
+    {
+        if ( i == MAX_PATH_NAMES && summary.criticalPath.size() > MAX_PATH_NAMES + 1 )
+        {
+            std::cout << " -> ... (" << summary.criticalPath.size() - MAX_PATH_NAMES - 1 << " more)";
+            i = summary.criticalPath.size() - 1;
+        }
+        std::cout << ( i == 0 ? " " : " -> " ) << graph.jobs[ summary.criticalPath[ i ] ].name;
+    }
+    std::cout << std::endl;
+}
+
+unsigned JobGraph_DefaultSlots( void )
+{
+    DWORD processors = GetActiveProcessorCount( ALL_PROCESSOR_GROUPS );
+    return ( processors != 0 ) ? ( unsigned ) processors : 1;
+}
+
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Create the job's process and have its exit posted to the port. */
+static BOOL StartJob( tJobGraph& graph, size_t index )
+{
+    tJob&               job = graph.jobs[ index ];
+    STARTUPINFOA        si;
+    PROCESS_INFORMATION pi;
+    std::vector<char>   commandLine( job.commandLine.begin(), job.commandLine.end() );
+
+    ZeroMemory( &si, sizeof( si ) );
+    si.cb = sizeof( si );
+    ZeroMemory( &pi, sizeof( pi ) );
+    commandLine.push_back( '\0' );
+
+    job.start = Timing_Now();
+    if ( !CreateProcessA(
+        NULL,                   // No module name (use command line)
+        commandLine.data(),     // Command line
+        NULL,                   // Process handle not inheritable
+        NULL,                   // Thread handle not inheritable
+        FALSE,                  // Set handle inheritance to FALSE
+        0,                      // No creation flags
+        NULL,                   // Use parent's environment block
+        NULL,                   // Use parent's starting directory
+        &si,                    // Pointer to STARTUPINFO structure
+        &pi                     // Pointer to PROCESS_INFORMATION structure
+    ) )
+    {
+        job.exitCode = GetLastError();
+        job.end      = job.start;
+        std::cout << "[RUNNER] Unable to start '" << job.name << "' (" << job.exitCode << ")" << std::endl;
+        return FALSE;
+    }
+    CloseHandle( pi.hThread );
+    job.hProcess = pi.hProcess;
+
+    if ( !RegisterWaitForSingleObject( &job.hWait, job.hProcess, OnExit, ( PVOID ) ( ULONG_PTR ) index, INFINITE,
+                                       WT_EXECUTEONLYONCE ) )
+    {
+        /* Without a wait the exit would never be seen, so do not let the job run unobserved. */
+        job.exitCode = GetLastError();
+        TerminateProcess( job.hProcess, job.exitCode );
+        CloseHandle( job.hProcess );
+        job.hProcess = NULL;
+        job.end      = Timing_Now();
+        std::cout << "[RUNNER] Unable to wait for '" << job.name << "' (" << job.exitCode << ")" << std::endl;
+        return FALSE;
+    }
+    job.state = JOB_STATE_RUNNING;
+    return TRUE;
+}
+
+/* Record the end of a job and release or skip its dependents. */
+static void FinishJob( tJobGraph& graph, size_t index, tJobState state )
+{
+    tJob& job = graph.jobs[ index ];
+
+    job.state = state;
+    ++runnerData.done;
+    if ( state == JOB_STATE_FAILED )
+    {
+        std::cout << "[RUNNER] '" << job.name << "' failed (" << job.exitCode << ")" << std::endl;
+    }
+
+    for ( size_t dependent : job.dependents )
+    {
+        tJob& next = graph.jobs[ dependent ];
+        if ( state != JOB_STATE_SUCCEEDED )
+        {
+            SkipJob( graph, dependent );
+        }
+        else if ( --next.remaining == 0 && next.state == JOB_STATE_WAITING )
+        {
+            next.state = JOB_STATE_READY;
+            runnerData.ready.push( tReadyJob{ next.priority, dependent } );
+        }
+    }
+}
+
+/* Stop observing a running job: wait for its callback to finish, end the process and fail the job. */
+static void AbandonJob( tJobGraph& graph, size_t index )
+{
+    tJob& job = graph.jobs[ index ];
+
+    UnregisterWaitEx( job.hWait, INVALID_HANDLE_VALUE );
+    job.hWait    = NULL;
+    job.exitCode = ERROR_OPERATION_ABORTED;
+    TerminateProcess( job.hProcess, job.exitCode );
+    CloseHandle( job.hProcess );
+    job.hProcess = NULL;
+    job.end      = Timing_Now();
+    FinishJob( graph, index, JOB_STATE_FAILED );
+}
+
+/* Skip a job that can no longer run, and everything after it. */
+static void SkipJob( tJobGraph& graph, size_t index )
+{
+    if ( graph.jobs[ index ].state != JOB_STATE_WAITING )
+    {
+        return;
+    }
+    graph.jobs[ index ].state = JOB_STATE_SKIPPED;
+    ++runnerData.done;
+    for ( size_t dependent : graph.jobs[ index ].dependents )
+    {
+        SkipJob( graph, dependent );
+    }
+}
+
+/* Text without leading and trailing white space. */
+static std::string Trim( std::string const & text )
+{
+    size_t begin = text.find_first_not_of( " \t\r\n" );
+    size_t end   = text.find_last_not_of( " \t\r\n" );
+    return ( begin == std::string::npos ) ? std::string() : text.substr( begin, end - begin + 1 );
+}
+
+/* Measured run time of a job, 0 if it did not run. */
+static double DurationMs( tJob const & job )
+{
+    return ( job.start != 0 && job.end > job.start ) ? Timing_TicksToNs( job.end - job.start ) / 1e6 : 0.0;
+}
+
+/* Name of a job's state. */
+static char const * StateName( tJob const & job )
+{
+    static char const * const names[] = { "waiting", "ready", "running", "ok", "FAILED", "skipped" };
+    return names[ job.state ];
+}
+
+/* Thread pool callback: a job's process has exited. */
+static VOID CALLBACK OnExit( PVOID pContext, BOOLEAN timedOut )
+{
+    PostQueuedCompletionStatus( runnerData.hPort, 0, ( ULONG_PTR ) pContext, NULL );
+}
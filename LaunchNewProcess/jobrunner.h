@@ -0,0 +1,126 @@
+/**
+ **********************************************************************************************************************
+ * @file       jobrunner.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Parallel runner of child processes with dependencies and a concurrency limit.
+ *
+ * A job file has one job per line, lines starting with '#' are comments:
+ *
+ *     name [weight=slots] [cost=ms] [after=name,name...] : command line
+ *
+ * A job starts as soon as every job it comes after has succeeded and enough of the runner's slots (by default one per
+ * logical processor) are free for its weight (default 1). Among ready jobs, the one with the longest estimated chain of
+ * dependents (sum of cost, default 1) goes first, so the critical path is not left waiting behind short side branches.
+ * A ready job too heavy for the free slots does not hold up lighter ones behind it, which may delay it until they run
+ * out. Dependents of a failed job are skipped.
+ **********************************************************************************************************************
+ */
+
+#ifndef JOBRUNNER_H
+#define JOBRUNNER_H
+
+#include <windows.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* State of a job. */
+typedef enum eJobState
+{
+    JOB_STATE_WAITING   = 0,    /* Dependencies not finished.      */
+    JOB_STATE_READY     = 1,    /* Waiting for free slots.         */
+    JOB_STATE_RUNNING   = 2,    /* Process running.                */
+    JOB_STATE_SUCCEEDED = 3,    /* Exited with code 0.             */
+    JOB_STATE_FAILED    = 4,    /* Did not start or exited non-0.  */
+    JOB_STATE_SKIPPED   = 5     /* A dependency failed.            */
+} tJobState;
+
+/* A job and its run. */
+typedef struct sJob
+{
+    std::string              name;          /* Unique name.                                  */
+    std::string              commandLine;   /* Passed to CreateProcessA.                     */
+    unsigned                 weight;        /* Slots used while running.                     */
+    double                   costMs;        /* Estimated run time, for ordering only.        */
+    std::vector<std::string> after;         /* Names of dependencies, as given.              */
+    std::vector<size_t>      dependencies;  /* Jobs that must succeed first.                 */
+    std::vector<size_t>      dependents;    /* Jobs that come after this one.                */
+    double                   priority;      /* Estimated cost of longest chain from here.    */
+    unsigned                 remaining;     /* Dependencies not yet succeeded.               */
+    tJobState                state;         /* Current state.                                */
+    HANDLE                   hProcess;      /* Process while running.                        */
+    HANDLE                   hWait;         /* Thread pool wait for the process.             */
+    DWORD                    exitCode;      /* Exit code, or Win32 error if it did not start. */
+    uint64_t                 start;         /* Timing_Now() when started.                    */
+    uint64_t                 end;           /* Timing_Now() when its exit was seen.          */
+} tJob;
+
+/* Set of jobs. */
+typedef struct sJobGraph
+{
+    std::vector<tJob>   jobs;       /* All jobs, in the order added.               */
+    std::vector<size_t> order;      /* Topological order, set by JobGraph_Link().  */
+} tJobGraph;
+
+/* Outcome of a run. */
+typedef struct sJobSummary
+{
+    double              makespanMs;     /* First start to last end.                            */
+    double              workMs;         /* Sum of job run times.                               */
+    double              criticalMs;     /* Longest dependency chain, by measured run times.    */
+    std::vector<size_t> criticalPath;   /* Jobs on it, first to last.                          */
+    unsigned            succeeded;      /* Jobs that exited with code 0.                       */
+    unsigned            failed;         /* Jobs that did not start or exited non-0.            */
+    unsigned            skipped;        /* Jobs not run because a dependency failed.           */
+} tJobSummary;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/* Add a job. after is a comma separated list of names, resolved by JobGraph_Link(). */
+void JobGraph_Add( tJobGraph& graph, std::string const & name, std::string const & commandLine, unsigned weight,
+                   double costMs, std::string const & after );
+
+/* Add the jobs of a job file. */
+BOOL JobGraph_Load( tJobGraph& graph, char const * fileName );
+
+/* Write the jobs in job file format. */
+BOOL JobGraph_Save( tJobGraph const & graph, char const * fileName );
+
+/* Resolve dependencies, reject unknown names and cycles, and order and prioritize the jobs. */
+BOOL JobGraph_Link( tJobGraph& graph );
+
+/* Run all jobs of a linked graph on at most slots slots. Returns TRUE if all of them succeeded. Needs Timing_Init(). */
+BOOL JobGraph_Execute( tJobGraph& graph, unsigned slots );
+
+/* Makespan, critical path and counts of an executed graph. */
+tJobSummary JobGraph_Summarize( tJobGraph const & graph );
+
+/* Print the summary and, if perJob, the timing of every job. */
+void JobGraph_Report( tJobGraph const & graph, bool perJob );
+
+/* One slot per logical processor. */
+unsigned JobGraph_DefaultSlots( void );
+
+/*
+ * Run a job file. Arguments (after "run" on the command line):
+ *   file             Job file.
+ *   -j slots         Concurrency limit (default: logical processors).
+ *   -q 1             Only print the summary.
+ * Returns process exit code.
+ */
+int JobRunner_Run( int argc, char** argv );
+
+#endif /* JOBRUNNER_H */
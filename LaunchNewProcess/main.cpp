@@ -1,6 +1,11 @@
 #include <Windows.h>
 #include <iostream>
 #include <tchar.h>
+#include <string.h>
+#include <vector>
+
+#include "jobbench.h"
+#include "jobrunner.h"
 
 int main( int argc, char *argv[] )
 {
@@ -14,14 +19,33 @@ int main( int argc, char *argv[] )
     if ( argc < 2 )
     {
         std::cout << "Usage: " << argv[ 0 ] << " [cmdline]" << std::endl;
+        std::cout << "       " << argv[ 0 ] << " run jobfile [-j slots] [-q 1]" << std::endl;
+        std::cout << "       " << argv[ 0 ] << " bench [-n jobs] [-j slots] [-w max_ms] [-d max_deps] [-s seed] [-o jobfile]" << std::endl;
         return 1;
     }
 
+    // Run a job file, or the job runner benchmark (and the jobs it launches), if asked to
+    if ( strcmp( argv[ 1 ], "run" ) == 0 )
+    {
+        return JobRunner_Run( argc - 2, argv + 2 );
+    }
+    if ( strcmp( argv[ 1 ], "bench" ) == 0 )
+    {
+        return JobBench_Run( argc - 2, argv + 2 );
+    }
+    if ( strcmp( argv[ 1 ], "work" ) == 0 )
+    {
+        return JobBench_Work( argc - 2, argv + 2 );
+    }
+
     const char *myModule = "C:\\Users\\lovgr\\GitHub\\win32api-tests\\x64\\Debug\\ThreadingTest.exe";
 
+    // Pass the (writable) command line on, ex. "ThreadingTest -t MultimediaTimerTest" to follow that tick page
+    std::vector<char> commandLine( argv[ 1 ], argv[ 1 ] + strlen( argv[ 1 ] ) + 1 );
+
     if ( !CreateProcessA(
         myModule,               // Module name (NULL = use command line)
-        NULL,                   // Command line
+        commandLine.data(),     // Command line
         NULL,                   // Process handle not inheritable
         NULL,                   // Thread handle not inheritable
         FALSE,                  // Set handle inheritance to FALSE
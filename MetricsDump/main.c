@@ -0,0 +1,490 @@
+/**
+ **********************************************************************************************************************
+ * @file       main.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Reads and aggregates the metrics segment published by another process (see Common/metrics.h).
+ *
+ * Usage: MetricsDump <name> [-w interval_ms] [-v] [-p socket_path]
+ *
+ *   <name>            Name passed to Metrics_Init() (ex. ThreadingTest) or full mapping name as printed at startup.
+ *   -w interval_ms    Keep dumping every interval_ms milliseconds until a key is pressed.
+ *   -v                Print per-slot (per-thread) values, not only the aggregate.
+ *   -p socket_path    Serve Prometheus text exposition over HTTP on a local (AF_UNIX) socket instead of printing.
+ **********************************************************************************************************************
+ */
+
+#include <winsock2.h>
+#include <afunix.h>
+#include <windows.h>
+#include <conio.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "metrics.h"
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Max length of the full mapping name. */
+#define MAPPING_NAME_LEN            ( 128 )
+
+/* Initial size of exposition text buffer, doubled whenever a scrape does not fit. */
+#define TEXT_BUF_SIZE               ( 256 * 1024 )
+
+/* How long a scraper may take to send its request or to accept the response. */
+#define CLIENT_TIMEOUT_MS           ( 2000 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Holds data for main. */
+typedef struct sMainData
+{
+    HANDLE            hMapping;                     /* Handle to the opened mapping.         */
+    tMetricsSegment*  pSegment;                     /* Read-only view of the segment.        */
+    char*             pText;                        /* Text buffer for Prometheus output.    */
+    size_t            textSize;                     /* Allocated size of text buffer.        */
+    size_t            textLen;                      /* Used length of text buffer.           */
+    BOOL              textFailed;                   /* Text buffer could not be grown.       */
+} tMainData;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static BOOL     OpenSegment( char const * name );
+static LONG     NumSlots( void );
+static void     PrintTable( BOOL verbose );
+static BOOL     BuildExposition( void );
+static void     Append( char const * format, ... );
+static int      ServePrometheus( char const * socketPath );
+static uint64_t BucketUpperBound( unsigned bucket );
+static uint64_t HistogramPercentile( uint64_t const * buckets, uint64_t count, double percentile );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Statically allocated data for "module" main. */
+static tMainData mainData;
+
+/* Names of metric types, indexed by tMetricType. */
+static char const * const metricTypeNames[] = { "counter", "gauge", "histogram" };
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+int main( int argc, char** argv )
+{
+    DWORD        interval   = 0;
+    BOOL         verbose    = FALSE;
+    char const * socketPath = NULL;
+
+    if ( argc < 2 )
+    {
+        printf( "Usage: %s <name> [-w interval_ms] [-v] [-p socket_path]\n", argv[ 0 ] );
+        return 1;
+    }
+
+    for ( int i = 2; i < argc; ++i )
+    {
+        if ( strcmp( argv[ i ], "-w" ) == 0 && i + 1 < argc )
+        {
+            interval = ( DWORD ) atoi( argv[ ++i ] );
+        }
+        else if ( strcmp( argv[ i ], "-v" ) == 0 )
+        {
+            verbose = TRUE;
+        }
+        else if ( strcmp( argv[ i ], "-p" ) == 0 && i + 1 < argc )
+        {
+            socketPath = argv[ ++i ];
+        }
+        else
+        {
+            printf( "Unknown argument %s\n", argv[ i ] );
+            return 1;
+        }
+    }
+
+    if ( !OpenSegment( argv[ 1 ] ) )
+    {
+        return 1;
+    }
+
+    int result = 0;
+    if ( socketPath != NULL )
+    {
+        result = ServePrometheus( socketPath );
+    }
+    else
+    {
+        do
+        {
+            PrintTable( verbose );
+            if ( interval == 0 )
+            {
+                break;
+            }
+            Sleep( interval );
+        } while ( !_kbhit() );
+    }
+
+    UnmapViewOfFile( mainData.pSegment );
+    CloseHandle( mainData.hMapping );
+    return result;
+}
+
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Open the mapping read-only, accepting either a short name or a full mapping name. */
+static BOOL OpenSegment( char const * name )
+{
+    char mappingName[ MAPPING_NAME_LEN ];
+
+    if ( strchr( name, '\\' ) != NULL )
+    {
+        strncpy_s( mappingName, sizeof( mappingName ), name, _TRUNCATE );
+    }
+    else
+    {
+        sprintf_s( mappingName, sizeof( mappingName ), "%s%s", METRICS_MAPPING_PREFIX, name );
+    }
+
+    mainData.hMapping = OpenFileMappingA( FILE_MAP_READ, FALSE, mappingName );
+    if ( mainData.hMapping == NULL )
+    {
+        printf( "Unable to open %s (%d)\n", mappingName, GetLastError() );
+        return FALSE;
+    }
+
+    mainData.pSegment = MapViewOfFile( mainData.hMapping, FILE_MAP_READ, 0, 0, sizeof( tMetricsSegment ) );
+    if ( mainData.pSegment == NULL )
+    {
+        printf( "Unable to map %s (%d)\n", mappingName, GetLastError() );
+        CloseHandle( mainData.hMapping );
+        return FALSE;
+    }
+
+    if ( mainData.pSegment->magic != METRICS_MAGIC || mainData.pSegment->version != METRICS_VERSION )
+    {
+        printf( "%s is not a metrics segment of version %d\n", mappingName, METRICS_VERSION );
+        UnmapViewOfFile( mainData.pSegment );
+        CloseHandle( mainData.hMapping );
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Number of slots that may be read (numSlots overshoots when the publisher ran out of slots). */
+static LONG NumSlots( void )
+{
+    LONG numSlots = mainData.pSegment->numSlots;
+    return ( numSlots > METRICS_MAX_SLOTS ) ? METRICS_MAX_SLOTS : numSlots;
+}
+
+/* Upper bound (inclusive) of a histogram bucket, UINT64_MAX for the overflow bucket. */
+static uint64_t BucketUpperBound( unsigned bucket )
+{
+    if ( bucket >= METRICS_HISTOGRAM_BUCKETS - 1 )
+    {
+        return UINT64_MAX;
+    }
+    return ( 1ULL << bucket ) - 1;
+}
+
+/* Approximate a percentile from aggregated buckets (upper bound of the bucket that holds it). */
+static uint64_t HistogramPercentile( uint64_t const * buckets, uint64_t count, double percentile )
+{
+    uint64_t target     = ( uint64_t ) ( count * percentile );
+    uint64_t cumulative = 0;
+
+    for ( unsigned b = 0; b < METRICS_HISTOGRAM_BUCKETS; ++b )
+    {
+        cumulative += buckets[ b ];
+        if ( cumulative > target )
+        {
+            return BucketUpperBound( b );
+        }
+    }
+    return BucketUpperBound( METRICS_HISTOGRAM_BUCKETS - 1 );
+}
+
+/* Print aggregated values as a table. */
+static void PrintTable( BOOL verbose )
+{
+    tMetricsSegment const * pSeg     = mainData.pSegment;
+    LONG                    numSlots = NumSlots();
+    LONG                    numDescs = pSeg->numMetrics;
+
+    MemoryBarrier();
+    printf( "--- pid %lu, %ld metrics, %ld slots ---\n", pSeg->processId, numDescs, numSlots );
+    printf( "%-40s %-10s %16s %12s %12s %12s\n", "metric", "type", "value/count", "mean", "p50<=", "p99<=" );
+
+    for ( LONG m = 0; m < numDescs; ++m )
+    {
+        tMetricDesc const * pDesc = &pSeg->metrics[ m ];
+
+        if ( pDesc->type == METRIC_TYPE_HISTOGRAM )
+        {
+            uint64_t buckets[ METRICS_HISTOGRAM_BUCKETS ] = { 0 };
+            uint64_t count = 0;
+            uint64_t sum   = 0;
+
+            for ( LONG s = 0; s < numSlots; ++s )
+            {
+                tMetricHistogram const * pHist = &pSeg->slots[ s ].histograms[ pDesc->index ];
+                uint64_t                 slotCount = Metrics_Load( &pHist->count );
+                uint64_t                 slotSum   = Metrics_Load( &pHist->sum );
+                count += slotCount;
+                sum   += slotSum;
+                for ( unsigned b = 0; b < METRICS_HISTOGRAM_BUCKETS; ++b )
+                {
+                    buckets[ b ] += Metrics_Load( &pHist->buckets[ b ] );
+                }
+                if ( verbose && pSeg->slots[ s ].inUse && slotCount != 0 )
+                {
+                    printf( "  %-38s %-10s %16llu %12.1f\n", pSeg->slots[ s ].name, "", slotCount,
+                            ( double ) slotSum / ( double ) slotCount );
+                }
+            }
+            printf( "%-40s %-10s %16llu %12.1f %12llu %12llu\n", pDesc->name, metricTypeNames[ pDesc->type ], count,
+                    count ? ( double ) sum / ( double ) count : 0.0,
+                    count ? HistogramPercentile( buckets, count, 0.50 ) : 0,
+                    count ? HistogramPercentile( buckets, count, 0.99 ) : 0 );
+        }
+        else
+        {
+            uint64_t total = 0;
+            for ( LONG s = 0; s < numSlots; ++s )
+            {
+                uint64_t value = Metrics_Load( &pSeg->slots[ s ].values[ pDesc->index ] );
+                total += value;
+                if ( verbose && pSeg->slots[ s ].inUse && value != 0 )
+                {
+                    printf( "  %-38s %-10s %16llu\n", pSeg->slots[ s ].name, "", value );
+                }
+            }
+            printf( "%-40s %-10s %16llu\n", pDesc->name, metricTypeNames[ pDesc->type ], total );
+        }
+    }
+}
+
+/* Append formatted text to the exposition buffer, growing it as needed. Sets textFailed if it cannot grow. */
+static void Append( char const * format, ... )
+{
+    va_list args;
+    int     length;
+
+    if ( mainData.textFailed )
+    {
+        return;
+    }
+
+    va_start( args, format );
+    length = _vscprintf( format, args );
+    va_end( args );
+    if ( length < 0 )
+    {
+        mainData.textFailed = TRUE;
+        return;
+    }
+
+    /* Never cut a line short, a partial series would make the whole scrape invalid. */
+    if ( mainData.textLen + ( size_t ) length + 1 > mainData.textSize )
+    {
+        size_t size = ( mainData.textSize != 0 ) ? mainData.textSize : TEXT_BUF_SIZE;
+        while ( mainData.textLen + ( size_t ) length + 1 > size )
+        {
+            size *= 2;
+        }
+        char* pText = realloc( mainData.pText, size );
+        if ( pText == NULL )
+        {
+            mainData.textFailed = TRUE;
+            return;
+        }
+        mainData.pText    = pText;
+        mainData.textSize = size;
+    }
+
+    va_start( args, format );
+    vsnprintf( mainData.pText + mainData.textLen, mainData.textSize - mainData.textLen, format, args );
+    va_end( args );
+    mainData.textLen += ( size_t ) length;
+}
+
+/*
+ * Build Prometheus text exposition (format 0.0.4) with one series per slot, labelled by slot name. Returns FALSE if
+ * the text buffer could not hold all of it.
+ */
+static BOOL BuildExposition( void )
+{
+    tMetricsSegment const * pSeg     = mainData.pSegment;
+    LONG                    numSlots = NumSlots();
+    LONG                    numDescs = pSeg->numMetrics;
+
+    MemoryBarrier();
+    mainData.textLen    = 0;
+    mainData.textFailed = FALSE;
+
+    for ( LONG m = 0; m < numDescs; ++m )
+    {
+        tMetricDesc const * pDesc = &pSeg->metrics[ m ];
+
+        Append( "# HELP %s %s\n", pDesc->name, pDesc->help );
+        Append( "# TYPE %s %s\n", pDesc->name, metricTypeNames[ pDesc->type ] );
+
+        for ( LONG s = 0; s < numSlots; ++s )
+        {
+            tMetricSlot const * pSlot = &pSeg->slots[ s ];
+            if ( !pSlot->inUse )
+            {
+                continue;
+            }
+
+            if ( pDesc->type == METRIC_TYPE_HISTOGRAM )
+            {
+                tMetricHistogram const * pHist      = &pSlot->histograms[ pDesc->index ];
+                uint64_t                 cumulative = 0;
+
+                for ( unsigned b = 0; b < METRICS_HISTOGRAM_BUCKETS - 1; ++b )
+                {
+                    cumulative += Metrics_Load( &pHist->buckets[ b ] );
+                    Append( "%s_bucket{thread=\"%s\",le=\"%llu\"} %llu\n", pDesc->name, pSlot->name,
+                            BucketUpperBound( b ), cumulative );
+                }
+                Append( "%s_bucket{thread=\"%s\",le=\"+Inf\"} %llu\n", pDesc->name, pSlot->name,
+                        Metrics_Load( &pHist->count ) );
+                Append( "%s_sum{thread=\"%s\"} %llu\n", pDesc->name, pSlot->name, Metrics_Load( &pHist->sum ) );
+                Append( "%s_count{thread=\"%s\"} %llu\n", pDesc->name, pSlot->name,
+                        Metrics_Load( &pHist->count ) );
+            }
+            else
+            {
+                Append( "%s{thread=\"%s\"} %llu\n", pDesc->name, pSlot->name,
+                        Metrics_Load( &pSlot->values[ pDesc->index ] ) );
+            }
+        }
+    }
+    return !mainData.textFailed;
+}
+
+/* Serve the exposition as a minimal HTTP/1.0 endpoint on an AF_UNIX socket until a key is pressed. */
+static int ServePrometheus( char const * socketPath )
+{
+    WSADATA            wsaData;
+    SOCKET             listener;
+    struct sockaddr_un address;
+
+    if ( WSAStartup( MAKEWORD( 2, 2 ), &wsaData ) != 0 )
+    {
+        printf( "WSAStartup failed\n" );
+        return 1;
+    }
+
+    listener = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( listener == INVALID_SOCKET )
+    {
+        printf( "Unable to create socket (%d)\n", WSAGetLastError() );
+        WSACleanup();
+        return 1;
+    }
+
+    memset( &address, 0, sizeof( address ) );
+    address.sun_family = AF_UNIX;
+    strncpy_s( address.sun_path, sizeof( address.sun_path ), socketPath, _TRUNCATE );
+    DeleteFileA( socketPath );
+
+    if ( bind( listener, ( struct sockaddr * ) &address, sizeof( address ) ) == SOCKET_ERROR ||
+         listen( listener, SOMAXCONN ) == SOCKET_ERROR )
+    {
+        printf( "Unable to listen on %s (%d)\n", socketPath, WSAGetLastError() );
+        closesocket( listener );
+        WSACleanup();
+        return 1;
+    }
+    printf( "Serving metrics on %s, press any key to stop.\n", socketPath );
+
+    while ( !_kbhit() )
+    {
+        fd_set         readSet;
+        struct timeval timeout = { 0, 200000 };
+
+        /* Poll so that a key press is noticed even when nobody scrapes. */
+        FD_ZERO( &readSet );
+        FD_SET( listener, &readSet );
+        if ( select( 0, &readSet, NULL, NULL, &timeout ) <= 0 )
+        {
+            continue;
+        }
+
+        SOCKET client = accept( listener, NULL, NULL );
+        if ( client == INVALID_SOCKET )
+        {
+            continue;
+        }
+
+        /* A client that connects and then stalls must not hold up the only thread serving scrapes. */
+        DWORD clientTimeout = CLIENT_TIMEOUT_MS;
+        setsockopt( client, SOL_SOCKET, SO_RCVTIMEO, ( char const * ) &clientTimeout, sizeof( clientTimeout ) );
+        setsockopt( client, SOL_SOCKET, SO_SNDTIMEO, ( char const * ) &clientTimeout, sizeof( clientTimeout ) );
+
+        /* Request content does not matter, there is only one resource. */
+        char request[ 1024 ];
+        if ( recv( client, request, sizeof( request ), 0 ) <= 0 )
+        {
+            closesocket( client );
+            continue;
+        }
+
+        char header[ 128 ];
+        int  headerLen;
+        if ( BuildExposition() )
+        {
+            headerLen = sprintf_s( header, sizeof( header ),
+                "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n\r\n",
+                mainData.textLen );
+            send( client, header, headerLen, 0 );
+            send( client, mainData.pText, ( int ) mainData.textLen, 0 );
+        }
+        else
+        {
+            printf( "Unable to grow exposition text beyond %zu bytes\n", mainData.textSize );
+            headerLen = sprintf_s( header, sizeof( header ),
+                "HTTP/1.0 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n" );
+            send( client, header, headerLen, 0 );
+        }
+        closesocket( client );
+    }
+
+    free( mainData.pText );
+    mainData.pText    = NULL;
+    mainData.textSize = 0;
+    closesocket( listener );
+    DeleteFileA( socketPath );
+    WSACleanup();
+    return 0;
+}
@@ -11,6 +11,13 @@
 #include <windows.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "loadgen.h"
+#include "metrics.h"
+#include "tickpage.h"
+#include "timing.h"
 
  /**
   **********************************************************************************************************************
@@ -26,6 +33,28 @@
 // Target resolution of multimedia timer (1ms)
 #define TARGET_RESOLUTION 1
 
+/* Period of the system tick timer (ms). */
+#define TICK_PERIOD_MS           ( 1 )
+
+/* Default load run by the worker on every observed tick (us). */
+#define DEFAULT_LOAD_US          ( 100 )
+
+/* Default number of ticks measured per step of a load sweep. */
+#define DEFAULT_SWEEP_TICKS      ( 2000 )
+
+/* Subscriber processes of the tick page benchmark, at most one per handle WaitForMultipleObjects takes. */
+#define DEFAULT_SUBSCRIBERS      ( 64 )
+#define MAX_SUBSCRIBERS          ( MAXIMUM_WAIT_OBJECTS )
+
+/* Back-to-back tick page reads timed by each subscriber. */
+#define TICKPAGE_READS           ( 1000000 )
+
+/* A subscriber gives up if no tick comes for this long (ms). */
+#define SUBSCRIBER_TIMEOUT_MS    ( 1000 )
+
+/* A subscriber gives up if the others of its step are not all started within this long (ms). */
+#define SUBSCRIBER_START_TIMEOUT_MS ( 30000 )
+
 /**
  **********************************************************************************************************************
  * Typedefs
@@ -44,8 +73,31 @@ typedef struct sThreadData
 typedef struct sMainData
 {
 	tThreadData threads[NUM_THREADS]; /* Data for all threads to be spawned. */
+	tMetricId   metricTicks;          /* Counter: system ticks observed.            */
+	tMetricId   metricMissed;         /* Counter: system ticks skipped by worker.   */
+	tMetricId   metricWakeLatency;    /* Histogram: time between observed ticks.    */
+	tMetricId   metricPending;        /* Gauge: ticks pending at last observation.  */
+	tLoadKind   loadKind;             /* Kind of load run per tick.                 */
+	uint64_t    loadNs;               /* Load run per tick (ns).                    */
+	size_t      workingSet;           /* Working set of memory loads (bytes).       */
+	tTickPublisher tickPage;          /* System tick published to other processes.  */
+	volatile LONG64 pageTick;         /* Last tick published to the tick page.      */
 } tMainData;
 
+/* Start of the results mapping of the tick page benchmark, followed by the results of each subscriber. */
+typedef struct __declspec(align(64)) sTickBenchControl
+{
+	volatile LONG ready; /* Subscribers of the step waiting at the start barrier. */
+} tTickBenchControl;
+
+/* Results of one subscriber process of the tick page benchmark, followed by its wake latencies (timestamp ticks). */
+typedef struct sSubscriberResult
+{
+	uint64_t readTicks;  /* Time spent in TICKPAGE_READS reads.     */
+	uint64_t count;      /* Wake latencies recorded.                */
+	uint64_t missed;     /* Ticks that went by without a wake-up.   */
+} tSubscriberResult;
+
 /**
  **********************************************************************************************************************
  * Prototypes
@@ -59,7 +111,11 @@ static DWORD WINAPI ThreadWaitableTimer(LPVOID pThreadData);
 
 VOID CALLBACK TimerCallback(PVOID lpParameter, BOOLEAN TimerOrWaitFired);
 
-int fibonacci(int n);
+static int    RunSweep(unsigned ticks);
+static int    RunTickBench(unsigned maxSubscribers, unsigned ticks);
+static int    RunSubscriber(int argc, char** argv);
+static size_t SubscriberResultSize(unsigned ticks);
+static UINT32 ReadSystemTick(void);
 
 
 /**
@@ -77,8 +133,8 @@ HANDLE ghStopEvent;
 /* Global system tick variable. */
 UINT32 SystemTick = 0;
 
-/* Just somewhere to put the fib-result to force it to not be optimized away. */
-volatile int fibresult = 0;
+/* Just somewhere to put the load result to force it to not be optimized away. */
+volatile uint64_t loadresult = 0;
 
 /**
  **********************************************************************************************************************
@@ -87,6 +143,55 @@ volatile int fibresult = 0;
  */
 int main(int argc, char** argv)
 {
+	/* Tick page subscriber started by the tick page benchmark. */
+	if (argc > 1 && strcmp(argv[1], "subscribe") == 0)
+	{
+		return RunSubscriber(argc - 2, argv + 2);
+	}
+
+	/* Parse options, "sweep" runs the jitter-vs-load sweep and "tickbench" the tick page benchmark instead of the worker thread. */
+	BOOL     sweep = (argc > 1 && strcmp(argv[1], "sweep") == 0);
+	BOOL     tickBench = (argc > 1 && strcmp(argv[1], "tickbench") == 0);
+	unsigned sweepTicks = DEFAULT_SWEEP_TICKS;
+	unsigned subscribers = DEFAULT_SUBSCRIBERS;
+
+	mainData.loadKind = LOAD_KIND_CPU;
+	mainData.loadNs = DEFAULT_LOAD_US * 1000ULL;
+	mainData.workingSet = LOADGEN_DEFAULT_WORKING_SET;
+	for (int i = (sweep || tickBench) ? 2 : 1; i < argc; i += 2)
+	{
+		char const * value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (value == NULL)
+			mainData.loadKind = LOAD_KIND_COUNT;
+		else if (strcmp(argv[i], "-l") == 0)
+			mainData.loadKind = LoadGen_ParseKind(value);
+		else if (strcmp(argv[i], "-u") == 0)
+			mainData.loadNs = strtoull(value, NULL, 10) * 1000ULL;
+		else if (strcmp(argv[i], "-m") == 0)
+			mainData.workingSet = (size_t)strtoull(value, NULL, 10) * 1024;
+		else if (strcmp(argv[i], "-t") == 0)
+			sweepTicks = (unsigned)atoi(value);
+		else if (strcmp(argv[i], "-p") == 0)
+			subscribers = (unsigned)atoi(value);
+		else
+			mainData.loadKind = LOAD_KIND_COUNT;
+	}
+	if (mainData.loadKind == LOAD_KIND_COUNT || sweepTicks == 0 || subscribers < 1 || subscribers > MAX_SUBSCRIBERS)
+	{
+		printf("Usage: MultimediaTimerTest [sweep|tickbench] [-l none|cpu|stream|chase|simd] [-u load_us] [-m working_set_kib] [-t ticks_per_step] [-p max_subscribers]\n");
+		return 1;
+	}
+
+	/* Load generators are calibrated against the timestamp counter. */
+	Timing_Init();
+	if (sweep)
+	{
+		return RunSweep(sweepTicks);
+	}
+	if (tickBench)
+	{
+		return RunTickBench(subscribers, sweepTicks);
+	}
 
 	/* Initialize main data. */
 	memset((void *)&mainData.threads, 0, sizeof(mainData.threads));
@@ -97,6 +202,16 @@ int main(int argc, char** argv)
 		NULL        /* No name.                  */
 	);
 
+	/* Publish live metrics (threads run without them if this fails). */
+	Metrics_Init("MultimediaTimerTest");
+	mainData.metricTicks = Metrics_Register("mmtimer_ticks_total", METRIC_TYPE_COUNTER, "System ticks observed by worker.");
+	mainData.metricMissed = Metrics_Register("mmtimer_missed_ticks_total", METRIC_TYPE_COUNTER, "System ticks the worker did not observe individually.");
+	mainData.metricWakeLatency = Metrics_Register("mmtimer_wake_interval_us", METRIC_TYPE_HISTOGRAM, "Time between observed system ticks in microseconds.");
+	mainData.metricPending = Metrics_Register("mmtimer_pending_ticks", METRIC_TYPE_GAUGE, "Ticks advanced since the previous observation.");
+
+	/* Publish the system tick to other processes (no-op in TimerCallback if this fails). */
+	TickPage_Create(&mainData.tickPage, "MultimediaTimerTest", TICK_PERIOD_MS * 1000000, TRUE);
+
 	/* Create threads and start them. */
 	tThreadData* pThread;
 
@@ -156,7 +271,7 @@ int main(int argc, char** argv)
 		TimerCallback,		// Callback function
 		NULL,				// No parameter to be sent to callback function
 		0,					// Time in milliseconds before first trigger
-		1,					// Period in milliseconds (0 for one-shot)
+		TICK_PERIOD_MS,		// Period in milliseconds (0 for one-shot)
 		WT_EXECUTEDEFAULT	// Flags
 	);
 	if (res == FALSE)
@@ -174,10 +289,10 @@ int main(int argc, char** argv)
 	/* Tell all threads to die by setting global stop event. */
 	SetEvent(ghStopEvent);
 
-	/* Delete queue timer(s) */
+	/* Delete queue timer(s), waiting for a running callback so the tick page can go. */
 	if (hTimer != INVALID_HANDLE_VALUE)
 	{
-		DeleteTimerQueueTimer(NULL, hTimer, NULL);
+		DeleteTimerQueueTimer(NULL, hTimer, INVALID_HANDLE_VALUE);
 	}
 
 	/* Wait for threads to stop. */
@@ -187,6 +302,8 @@ int main(int argc, char** argv)
 		CloseHandle(mainData.threads[i].threadHandle);
 	}
 	CloseHandle(ghStopEvent);
+	TickPage_Destroy(&mainData.tickPage);
+	Metrics_Shutdown();
 
 	printf("Goodbye from main!\n");
 	return 0;
@@ -393,6 +510,18 @@ static DWORD WINAPI ThreadWorker(LPVOID pThreadData)
 	// Own systick tester
 	UINT32 IntSystick = SystemTick;
 
+	// Own metrics slot
+	tMetricSlot* pMetrics = Metrics_AcquireSlot(pData->name);
+
+	// Own load generator, run once per observed tick
+	tLoadGen load;
+	if (!LoadGen_Init(&load, mainData.loadKind, mainData.workingSet))
+	{
+		printf("[THREAD %s] Unable to set up %s load.\n", pData->name, LoadGen_KindName(mainData.loadKind));
+		return 0;
+	}
+	printf("[THREAD %s] Running %llu us of %s load per tick (%.2f ns per unit).\n", pData->name, mainData.loadNs / 1000, LoadGen_KindName(mainData.loadKind), load.nsPerUnit);
+
 	// Set up high resolution time measurement
 	BOOL first = TRUE;
 	LARGE_INTEGER Start, End, ElapsedMicroseconds,Max,Min;
@@ -413,6 +542,7 @@ static DWORD WINAPI ThreadWorker(LPVOID pThreadData)
 			printf("[THREAD %s] Shutting down!\n", pData->name);
 			CancelWaitableTimer(waitableTimer);
 			CloseHandle(waitableTimer);
+			LoadGen_Destroy(&load);
 			return 0;
 		}
 		case WAIT_TIMEOUT:
@@ -435,11 +565,16 @@ static DWORD WINAPI ThreadWorker(LPVOID pThreadData)
 					first = FALSE;
 				}
 				QueryPerformanceCounter(&Start); // Restart measurement
+				UINT32 Advanced = SystemTick - IntSystick;
+				Metrics_CounterAdd(pMetrics, mainData.metricTicks, Advanced);
+				Metrics_CounterAdd(pMetrics, mainData.metricMissed, Advanced - 1);
+				Metrics_HistogramObserve(pMetrics, mainData.metricWakeLatency, ElapsedMicroseconds.QuadPart);
+				Metrics_GaugeSet(pMetrics, mainData.metricPending, Advanced);
 				printf("[THREAD %s] System tick advanced [%d] steps! (#%d, %llu us, %llu us, %llu us)\n", pData->name, SystemTick - IntSystick, helloCount, Max.QuadPart, Min.QuadPart, ElapsedMicroseconds.QuadPart);
 				IntSystick = SystemTick;
-				
-				// Calculate fibonacci
-				fibresult = fibonacci( helloCount % 10 );
+
+				// Run the per-tick load
+				loadresult = LoadGen_Run(&load, mainData.loadNs);
 
 			}
 			break;
@@ -449,6 +584,7 @@ static DWORD WINAPI ThreadWorker(LPVOID pThreadData)
 			printf("[THREAD %s] WaitForSingleObject failed (%d)\n", pData->name, GetLastError());
 			CancelWaitableTimer(waitableTimer);
 			CloseHandle(waitableTimer);
+			LoadGen_Destroy(&load);
 			return 0;
 		}
 		}
@@ -458,12 +594,332 @@ static DWORD WINAPI ThreadWorker(LPVOID pThreadData)
 VOID CALLBACK TimerCallback(PVOID lpParameter, BOOLEAN TimerOrWaitFired)
 {
 	++SystemTick;
+
+	// Publish to subscriber processes, 64-bit so the page tick never wraps
+	TickPage_Publish(&mainData.tickPage, (uint64_t)InterlockedIncrement64(&mainData.pageTick));
+}
+
+/* Read the system tick without letting the compiler cache it. */
+static UINT32 ReadSystemTick(void)
+{
+	return *(volatile UINT32 *)&SystemTick;
+}
+
+/* Run the load at a range of fractions of the tick period and report how wakeup jitter and missed ticks scale. */
+static int RunSweep(unsigned ticks)
+{
+	static double const loadFractions[] = { 0.0, 0.25, 0.5, 0.75, 0.9, 1.0, 1.1 };
+	uint64_t const      period = Timing_NsToTicks(TICK_PERIOD_MS * 1000000ULL);
+	tLoadGen            load;
+	HANDLE              hTimer = NULL;
+
+	uint64_t* pIntervals = malloc(ticks * sizeof(uint64_t));
+	uint64_t* pJitter = malloc(ticks * sizeof(uint64_t));
+	if (pIntervals == NULL || pJitter == NULL || !LoadGen_Init(&load, mainData.loadKind, mainData.workingSet))
+	{
+		printf("[SWEEP] Unable to set up %s load.\n", LoadGen_KindName(mainData.loadKind));
+		free(pIntervals);
+		free(pJitter);
+		return 1;
+	}
+	if (!CreateTimerQueueTimer(&hTimer, NULL, TimerCallback, NULL, 0, TICK_PERIOD_MS, WT_EXECUTEDEFAULT))
+	{
+		printf("Unable to create timer.");
+		LoadGen_Destroy(&load);
+		free(pIntervals);
+		free(pJitter);
+		return 1;
+	}
+
+	printf("[SWEEP] %s load (%.2f ns per unit, %zu KiB working set), %u ticks of %d ms per step\n\n", LoadGen_KindName(mainData.loadKind), load.nsPerUnit, mainData.workingSet / 1024, ticks, TICK_PERIOD_MS);
+	printf("%6s %10s %10s %10s %10s %10s %12s %12s %8s\n", "load", "target us", "ran us", "p50 us", "p99 us", "max us", "jit p99 us", "jit max us", "missed");
+
+	for (unsigned i = 0; i < sizeof(loadFractions) / sizeof(loadFractions[0]); ++i)
+	{
+		uint64_t loadNs = (uint64_t)(loadFractions[i] * TICK_PERIOD_MS * 1000000.0);
+		uint64_t busy = 0;
+		uint64_t previous = 0;
+		UINT32   missed = 0;
+		UINT32   tick = ReadSystemTick();
+
+		/* Synchronize to a tick edge, then record the interval between every observed tick. */
+		for (unsigned n = 0; n <= ticks; ++n)
+		{
+			UINT32 now;
+			while ((now = ReadSystemTick()) == tick)
+			{
+				YieldProcessor();
+			}
+			uint64_t woken = Timing_Now();
+			if (n > 0)
+			{
+				pIntervals[n - 1] = woken - previous;
+				missed += now - tick - 1;
+			}
+			tick = now;
+			previous = woken;
+			loadresult = LoadGen_Run(&load, loadNs);
+			busy += Timing_Now() - woken;
+		}
+
+		/* Jitter is the deviation from the tick period in either direction. */
+		for (unsigned n = 0; n < ticks; ++n)
+		{
+			pJitter[n] = (pIntervals[n] > period) ? pIntervals[n] - period : period - pIntervals[n];
+		}
+		Timing_Sort(pIntervals, ticks);
+		Timing_Sort(pJitter, ticks);
+
+		printf("%5.0f%% %10.1f %10.1f %10.1f %10.1f %10.1f %12.1f %12.1f %8u\n",
+			loadFractions[i] * 100.0,
+			loadNs / 1000.0,
+			Timing_TicksToNs(busy) / 1000.0 / (ticks + 1),
+			Timing_TicksToNs(Timing_Percentile(pIntervals, ticks, 0.50)) / 1000.0,
+			Timing_TicksToNs(Timing_Percentile(pIntervals, ticks, 0.99)) / 1000.0,
+			Timing_TicksToNs(pIntervals[ticks - 1]) / 1000.0,
+			Timing_TicksToNs(Timing_Percentile(pJitter, ticks, 0.99)) / 1000.0,
+			Timing_TicksToNs(pJitter[ticks - 1]) / 1000.0,
+			missed);
+	}
+
+	DeleteTimerQueueTimer(NULL, hTimer, INVALID_HANDLE_VALUE);
+	LoadGen_Destroy(&load);
+	free(pIntervals);
+	free(pJitter);
+	return 0;
+}
+
+/* Size of the results of one subscriber, including its wake latencies. */
+static size_t SubscriberResultSize(unsigned ticks)
+{
+	return sizeof(tSubscriberResult) + ticks * sizeof(uint64_t);
 }
 
-int fibonacci(int n)
+/*
+ * Start 1, 2, 4... subscriber processes on a tick page with wake events, and report what a read costs them and how
+ * long after a publish they are running again. Each step runs for ticks ticks.
+ */
+static int RunTickBench(unsigned maxSubscribers, unsigned ticks)
 {
-	if (n == 0 || n == 1)
-		return n;
-	else
-		return (fibonacci(n - 1) + fibonacci(n - 2));
+	tTickPublisher* pPublisher = &mainData.tickPage;
+	char            pageName[TICKPAGE_NAME_LEN];
+	char            resultsName[TICKPAGE_NAME_LEN];
+	char            startName[TICKPAGE_NAME_LEN];
+	char            self[MAX_PATH];
+	char            commandLine[MAX_PATH + TICKPAGE_NAME_LEN];
+	HANDLE          processes[MAX_SUBSCRIBERS];
+	HANDLE          hTimer = NULL;
+	HANDLE          hStart = NULL;
+	size_t const    resultSize = SubscriberResultSize(ticks);
+	ULARGE_INTEGER  mappingSize;
+	int             result = 0;
+
+	sprintf_s(pageName, sizeof(pageName), "TickBench.%lu", GetCurrentProcessId());
+	sprintf_s(resultsName, sizeof(resultsName), "%s%s.Results", TICKPAGE_MAPPING_PREFIX, pageName);
+	sprintf_s(startName, sizeof(startName), "%s%s.Start", TICKPAGE_MAPPING_PREFIX, pageName);
+	GetModuleFileNameA(NULL, self, sizeof(self));
+	if (!TickPage_Create(pPublisher, pageName, TICK_PERIOD_MS * 1000000, TRUE))
+	{
+		return 1;
+	}
+
+	/* Subscribers write their results into a mapping of their own, the tick page stays read-only to them. */
+	mappingSize.QuadPart = sizeof(tTickBenchControl) + (ULONGLONG)resultSize * MAX_SUBSCRIBERS;
+	HANDLE    hResults = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, mappingSize.HighPart, mappingSize.LowPart, resultsName);
+	uint8_t*  pResults = (hResults != NULL) ? MapViewOfFile(hResults, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)mappingSize.QuadPart) : NULL;
+	uint64_t* pLatencies = malloc((size_t)MAX_SUBSCRIBERS * ticks * sizeof(uint64_t));
+	hStart = CreateEventA(NULL, TRUE, FALSE, startName);
+	if (pResults == NULL || pLatencies == NULL || hStart == NULL)
+	{
+		printf("[TICKBENCH] Unable to set up results (%d)\n", GetLastError());
+		result = 1;
+		goto cleanup;
+	}
+	if (!CreateTimerQueueTimer(&hTimer, NULL, TimerCallback, NULL, 0, TICK_PERIOD_MS, WT_EXECUTEDEFAULT))
+	{
+		printf("Unable to create timer.");
+		result = 1;
+		goto cleanup;
+	}
+
+	printf("[TICKBENCH] %u ticks of %d ms per step, %d reads per subscriber\n\n", ticks, TICK_PERIOD_MS, TICKPAGE_READS);
+	printf("%11s %10s %10s %10s %10s %10s %8s\n", "subscribers", "read ns", "wake p50", "wake p99", "p99.9 us", "max us", "missed");
+
+	for (unsigned subscribers = 1; subscribers <= maxSubscribers && result == 0; subscribers *= 2)
+	{
+		unsigned started = 0;
+		double   readNs = 0.0;
+		uint64_t missed = 0;
+		size_t   count = 0;
+
+		/* The last subscriber to reach the start barrier releases the others, see RunSubscriber(). */
+		memset(pResults, 0, sizeof(tTickBenchControl) + resultSize * subscribers);
+		ResetEvent(hStart);
+		for (unsigned i = 0; i < subscribers; ++i)
+		{
+			STARTUPINFOA        startupInfo;
+			PROCESS_INFORMATION processInfo;
+
+			memset(&startupInfo, 0, sizeof(startupInfo));
+			startupInfo.cb = sizeof(startupInfo);
+			sprintf_s(commandLine, sizeof(commandLine), "\"%s\" subscribe %s %u %u %u", self, pageName, i, ticks, subscribers);
+			if (!CreateProcessA(NULL, commandLine, NULL, NULL, FALSE, 0, NULL, NULL, &startupInfo, &processInfo))
+			{
+				printf("[TICKBENCH] Unable to start subscriber (%d)\n", GetLastError());
+				result = 1;
+				break;
+			}
+			CloseHandle(processInfo.hThread);
+			processes[started++] = processInfo.hProcess;
+		}
+		if (started > 0)
+		{
+			WaitForMultipleObjects(started, processes, TRUE, INFINITE);
+		}
+
+		/* Pool the wake latencies of all subscribers of the step. */
+		for (unsigned i = 0; i < started; ++i)
+		{
+			tSubscriberResult const * pResult = (tSubscriberResult const *)(pResults + sizeof(tTickBenchControl) + i * resultSize);
+			DWORD                     exitCode = 1;
+
+			GetExitCodeProcess(processes[i], &exitCode);
+			CloseHandle(processes[i]);
+			if (exitCode != 0)
+			{
+				result = 1;
+			}
+			readNs += Timing_TicksToNs(pResult->readTicks) / TICKPAGE_READS / started;
+			missed += pResult->missed;
+			memcpy(pLatencies + count, pResult + 1, (size_t)pResult->count * sizeof(uint64_t));
+			count += (size_t)pResult->count;
+		}
+		if (result != 0 || count == 0)
+		{
+			printf("[TICKBENCH] A subscriber failed\n");
+			result = 1;
+			break;
+		}
+		Timing_Sort(pLatencies, count);
+
+		printf("%11u %10.1f %10.1f %10.1f %10.1f %10.1f %8llu\n",
+			subscribers,
+			readNs,
+			Timing_TicksToNs(Timing_Percentile(pLatencies, count, 0.50)) / 1000.0,
+			Timing_TicksToNs(Timing_Percentile(pLatencies, count, 0.99)) / 1000.0,
+			Timing_TicksToNs(Timing_Percentile(pLatencies, count, 0.999)) / 1000.0,
+			Timing_TicksToNs(pLatencies[count - 1]) / 1000.0,
+			missed);
+	}
+
+cleanup:
+	if (hTimer != NULL)
+	{
+		DeleteTimerQueueTimer(NULL, hTimer, INVALID_HANDLE_VALUE);
+	}
+	if (hStart != NULL)
+	{
+		CloseHandle(hStart);
+	}
+	if (pResults != NULL)
+	{
+		UnmapViewOfFile(pResults);
+	}
+	if (hResults != NULL)
+	{
+		CloseHandle(hResults);
+	}
+	free(pLatencies);
+	TickPage_Destroy(pPublisher);
+	return result;
+}
+
+/*
+ * Subscriber process of the tick page benchmark: "subscribe page slot ticks subscribers". Waits until all subscribers
+ * of the step are running, times back-to-back reads, then sleeps on the page for ticks ticks and records how long after
+ * each publish it woke.
+ */
+static int RunSubscriber(int argc, char** argv)
+{
+	tTickSubscriber subscriber;
+	tTickSample     sample;
+	char            resultsName[TICKPAGE_NAME_LEN];
+	char            startName[TICKPAGE_NAME_LEN];
+
+	if (argc < 4 || (unsigned)atoi(argv[1]) >= MAX_SUBSCRIBERS || atoi(argv[2]) < 1 || atoi(argv[3]) < 1 || !TickPage_Open(&subscriber, argv[0]))
+	{
+		return 1;
+	}
+
+	unsigned const slot = (unsigned)atoi(argv[1]);
+	unsigned const ticks = (unsigned)atoi(argv[2]);
+	unsigned const subscribers = (unsigned)atoi(argv[3]);
+	size_t const   resultSize = SubscriberResultSize(ticks);
+
+	sprintf_s(resultsName, sizeof(resultsName), "%s%s.Results", TICKPAGE_MAPPING_PREFIX, argv[0]);
+	sprintf_s(startName, sizeof(startName), "%s%s.Start", TICKPAGE_MAPPING_PREFIX, argv[0]);
+	HANDLE   hStart = OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, startName);
+	HANDLE   hResults = OpenFileMappingA(FILE_MAP_WRITE, FALSE, resultsName);
+	uint8_t* pView = (hResults != NULL) ? MapViewOfFile(hResults, FILE_MAP_WRITE, 0, 0, sizeof(tTickBenchControl) + resultSize * (slot + 1)) : NULL;
+	if (pView == NULL || hStart == NULL)
+	{
+		printf("[SUBSCRIBER %u] Unable to open results (%d)\n", slot, GetLastError());
+		if (pView != NULL)
+		{
+			UnmapViewOfFile(pView);
+		}
+		if (hResults != NULL)
+		{
+			CloseHandle(hResults);
+		}
+		if (hStart != NULL)
+		{
+			CloseHandle(hStart);
+		}
+		TickPage_Close(&subscriber);
+		return 1;
+	}
+	tTickBenchControl* pControl = (tTickBenchControl*)pView;
+	tSubscriberResult* pResult = (tSubscriberResult*)(pView + sizeof(tTickBenchControl) + slot * resultSize);
+	uint64_t*          pLatencies = (uint64_t*)(pResult + 1);
+	int                result = 1;
+
+	/* Start barrier: measure only once every subscriber of the step exists, so that all of them wait on each tick. */
+	if ((unsigned)InterlockedIncrement(&pControl->ready) == subscribers)
+	{
+		SetEvent(hStart);
+	}
+	else if (WaitForSingleObject(hStart, SUBSCRIBER_START_TIMEOUT_MS) != WAIT_OBJECT_0)
+	{
+		printf("[SUBSCRIBER %u] Not all subscribers started\n", slot);
+		goto cleanup;
+	}
+
+	/* Read cost, while the publisher keeps ticking. No calibration needed here, the parent converts the timestamps. */
+	uint64_t start = Timing_Now();
+	for (unsigned n = 0; n < TICKPAGE_READS; ++n)
+	{
+		TickPage_Read(&subscriber, &sample);
+		loadresult += sample.tick;
+	}
+	pResult->readTicks = Timing_Now() - start;
+
+	/* Wake latency, from the publisher's timestamp of a tick to running again after sleeping on it. */
+	TickPage_Read(&subscriber, &sample);
+	uint64_t seen = sample.tick;
+	while (pResult->count < ticks && TickPage_Wait(&subscriber, seen, SUBSCRIBER_TIMEOUT_MS, &sample))
+	{
+		uint64_t woken = Timing_Now();
+		pLatencies[pResult->count++] = (woken > sample.timestamp) ? woken - sample.timestamp : 0;
+		pResult->missed += sample.tick - seen - 1;
+		seen = sample.tick;
+	}
+	result = (pResult->count == ticks) ? 0 : 1;
+
+cleanup:
+	UnmapViewOfFile(pView);
+	CloseHandle(hResults);
+	CloseHandle(hStart);
+	TickPage_Close(&subscriber);
+	return result;
 }
\ No newline at end of file
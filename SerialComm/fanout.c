@@ -0,0 +1,363 @@
+/**
+ **********************************************************************************************************************
+ * @file       fanout.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Fan-out benchmark of received data: broadcast ring against a copy per consumer.
+ *
+ * The main thread plays the RX thread of a port: it "reads" chunks from the port (a memcpy from a pattern, which is
+ * what ReadFile does with the driver's buffer) and hands them to consumer threads that checksum every byte, like a
+ * parser or recorder would touch it. In broadcast mode it reads straight into a span claimed from one shared ring. In
+ * copy mode it reads into its own RX buffer and copies that into a separate ring per consumer, so both modes use the
+ * same ring code and differ only in the copies.
+ **********************************************************************************************************************
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bcastring.h"
+#include "fanout.h"
+#include "timing.h"
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Max number of consumers, one ring slot is kept for the monitor. */
+#define FANOUT_MAX_CONSUMERS        ( BCASTRING_MAX_CONSUMERS - 1 )
+
+/* Size of the data pattern the "port" delivers, power of two. */
+#define PATTERN_SIZE                ( 4096 )
+
+/* Defaults. */
+#define DEFAULT_MIB                 ( 256 )
+#define DEFAULT_CHUNK               ( 1024 )
+#define DEFAULT_RING_KIB            ( 64 )
+
+/* Time the lossy monitor spends on each span, like a console redraw. */
+#define MONITOR_DELAY_MS            ( 1 )
+
+/* Number of consumer counts run when none is given. */
+#define NUM_DEFAULT_CONSUMERS       ( sizeof( defaultConsumers ) / sizeof( defaultConsumers[ 0 ] ) )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* How received data reaches the consumers. */
+typedef enum eFanoutMode
+{
+    FANOUT_MODE_BROADCAST = 0,      /* One shared ring, written once.                   */
+    FANOUT_MODE_COPY      = 1       /* One ring per consumer, written once per consumer. */
+} tFanoutMode;
+
+/* Holds data for a consumer thread. */
+typedef struct __declspec( align( 64 ) ) sConsumerThread
+{
+    HANDLE      threadHandle;   /* Handle to win32 thread itself.       */
+    tBcastRing* pRing;          /* Ring read from.                      */
+    int         consumer;       /* Consumer ID in ring.                 */
+    BOOL        monitor;        /* Slow lossy monitor.                  */
+    uint64_t    checksum;       /* Sum of bytes read.                   */
+    uint64_t    bytes;          /* Bytes read.                          */
+    uint64_t    lost;           /* Bytes lost (monitor only).           */
+    uint64_t    end;            /* Timestamp when the ring was drained. */
+} tConsumerThread;
+
+/* Holds data for the fanout "module". */
+typedef struct sFanoutData
+{
+    tBcastRing      rings[ FANOUT_MAX_CONSUMERS + 1 ];      /* Shared ring, or one per consumer and monitor.  */
+    tConsumerThread threads[ FANOUT_MAX_CONSUMERS + 1 ];    /* Consumers followed by the monitor.             */
+    HANDLE          hStartEvent;                            /* Released when all threads exist.               */
+    unsigned        numConsumers;                           /* Consumers in this run, monitor not included.   */
+    BOOL            monitor;                                /* Attach a lossy monitor.                        */
+    size_t          chunk;                                  /* Bytes per read.                                */
+    size_t          ringSize;                               /* Bytes per ring.                                */
+    uint64_t        totalBytes;                             /* Bytes per run.                                 */
+    uint64_t        expectedChecksum;                       /* Sum of all bytes of a run.                     */
+    uint8_t*        pRxBuffer;                              /* RX buffer of copy mode.                        */
+    uint8_t         pattern[ PATTERN_SIZE ];                /* Data delivered by the "port".                  */
+} tFanoutData;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static DWORD WINAPI ConsumerThread( LPVOID pThreadData );
+static BOOL         RunOnce( tFanoutMode mode );
+static void         ReadPort( uint8_t* pDest, size_t size, uint64_t position );
+static uint64_t     Checksum( uint8_t const * pData, size_t size );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Statically allocated data for "module" fanout. */
+static tFanoutData fanoutData;
+
+/* Consumer counts run when none is given. */
+static unsigned const defaultConsumers[] = { 1, 2, 4, 8 };
+
+/* Names of modes, indexed by tFanoutMode. */
+static char const * const modeNames[] = { "broadcast", "copy" };
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+int Fanout_Run( int argc, char** argv )
+{
+    unsigned consumers = 0;
+    unsigned mib       = DEFAULT_MIB;
+    unsigned ringKib   = DEFAULT_RING_KIB;
+
+    memset( ( void * ) &fanoutData, 0, sizeof( fanoutData ) );
+    fanoutData.chunk = DEFAULT_CHUNK;
+
+    for ( int i = 0; i + 1 < argc; i += 2 )
+    {
+        unsigned value = ( unsigned ) atoi( argv[ i + 1 ] );
+        if      ( strcmp( argv[ i ], "-c" ) == 0 ) consumers          = value;
+        else if ( strcmp( argv[ i ], "-m" ) == 0 ) mib                = value;
+        else if ( strcmp( argv[ i ], "-s" ) == 0 ) fanoutData.chunk   = value;
+        else if ( strcmp( argv[ i ], "-r" ) == 0 ) ringKib            = value;
+        else if ( strcmp( argv[ i ], "-l" ) == 0 ) fanoutData.monitor = ( value != 0 );
+        else argc = -1;
+    }
+
+    fanoutData.ringSize   = ( size_t ) ringKib * 1024;
+    fanoutData.totalBytes = ( uint64_t ) mib * 1024 * 1024;
+    if ( argc < 0 || ( argc % 2 ) != 0 || consumers > FANOUT_MAX_CONSUMERS || mib < 1 || fanoutData.chunk < 1 ||
+         ringKib < 1 || ( ringKib & ( ringKib - 1 ) ) != 0 )
+    {
+        printf( "Usage: SerialComm fanout [-c consumers (max %d)] [-m MiB] [-s read size] [-r ring KiB (power of two)] "
+                "[-l 1 (lossy monitor)]\n", FANOUT_MAX_CONSUMERS );
+        return 1;
+    }
+
+    fanoutData.pRxBuffer   = malloc( fanoutData.chunk );
+    fanoutData.hStartEvent = CreateEvent(
+        NULL,       /* No security attributes.   */
+        TRUE,       /* Manual reset.             */
+        FALSE,      /* Initial state FALSE.      */
+        NULL        /* No name.                  */
+    );
+    if ( fanoutData.pRxBuffer == NULL || fanoutData.hStartEvent == NULL )
+    {
+        printf( "[FANOUT] Unable to allocate benchmark resources.\n" );
+        free( fanoutData.pRxBuffer );
+        return 1;
+    }
+
+    /* Pattern of the "port", and the checksum every consumer must end up with. */
+    uint64_t patternSum = 0;
+    for ( unsigned i = 0; i < PATTERN_SIZE; ++i )
+    {
+        fanoutData.pattern[ i ] = ( uint8_t ) ( ( i * 2654435761u ) >> 24 );
+        patternSum += fanoutData.pattern[ i ];
+    }
+    fanoutData.expectedChecksum = ( fanoutData.totalBytes / PATTERN_SIZE ) * patternSum;
+
+    printf( "[FANOUT] Calibrating timer...\n" );
+    Timing_Init();
+
+    printf( "[FANOUT] %u MiB per run, %u byte reads, %u KiB rings%s\n\n", mib, ( unsigned ) fanoutData.chunk,
+            ringKib, fanoutData.monitor ? ", lossy monitor attached" : "" );
+    printf( "%9s %-10s %12s %12s %12s %14s\n", "consumers", "mode", "MB/s in", "MB/s out", "writes/byte",
+            "monitor lost" );
+
+    BOOL ok = TRUE;
+    for ( unsigned c = 0; c < ( consumers ? 1 : NUM_DEFAULT_CONSUMERS ); ++c )
+    {
+        fanoutData.numConsumers = consumers ? consumers : defaultConsumers[ c ];
+        ok &= RunOnce( FANOUT_MODE_BROADCAST );
+        ok &= RunOnce( FANOUT_MODE_COPY );
+    }
+
+    CloseHandle( fanoutData.hStartEvent );
+    free( fanoutData.pRxBuffer );
+    return ok ? 0 : 1;
+}
+
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Stream all data to the consumers once and print the result. */
+static BOOL RunOnce( tFanoutMode mode )
+{
+    HANDLE   handles[ FANOUT_MAX_CONSUMERS + 1 ];
+    unsigned numThreads = fanoutData.numConsumers + ( fanoutData.monitor ? 1 : 0 );
+    unsigned numRings   = ( mode == FANOUT_MODE_BROADCAST ) ? 1 : numThreads;
+
+    for ( unsigned r = 0; r < numRings; ++r )
+    {
+        if ( !BcastRing_Init( &fanoutData.rings[ r ], fanoutData.ringSize ) )
+        {
+            printf( "[FANOUT] Unable to create ring %u\n", r );
+            while ( r-- > 0 )
+            {
+                BcastRing_Destroy( &fanoutData.rings[ r ] );
+            }
+            return FALSE;
+        }
+    }
+
+    /* Consumers are added before the producer starts, so that gating ones see every byte. */
+    ResetEvent( fanoutData.hStartEvent );
+    for ( unsigned i = 0; i < numThreads; ++i )
+    {
+        tConsumerThread* pThread = &fanoutData.threads[ i ];
+        memset( ( void * ) pThread, 0, sizeof( *pThread ) );
+        pThread->monitor      = ( i == fanoutData.numConsumers );
+        pThread->pRing        = &fanoutData.rings[ ( mode == FANOUT_MODE_BROADCAST ) ? 0 : i ];
+        pThread->consumer     = BcastRing_AddConsumer( pThread->pRing, pThread->monitor );
+        pThread->threadHandle = CreateThread( NULL, 0, ConsumerThread, pThread, 0, NULL );
+        if ( pThread->threadHandle == NULL )
+        {
+            /* A missing consumer would stall the producer forever. */
+            printf( "[FANOUT] Unable to create thread (%d)\n", GetLastError() );
+            ExitProcess( 1 );
+        }
+        handles[ i ] = pThread->threadHandle;
+    }
+
+    SetEvent( fanoutData.hStartEvent );
+    uint64_t start    = Timing_Now();
+    uint64_t position = 0;
+    while ( position < fanoutData.totalBytes )
+    {
+        size_t size = fanoutData.chunk;
+        if ( size > fanoutData.totalBytes - position )
+        {
+            size = ( size_t ) ( fanoutData.totalBytes - position );
+        }
+
+        if ( mode == FANOUT_MODE_BROADCAST )
+        {
+            /* Read straight into the ring, possibly less than asked for at the end of the buffer. */
+            uint8_t* pSpan = BcastRing_Claim( &fanoutData.rings[ 0 ], &size );
+            ReadPort( pSpan, size, position );
+            BcastRing_Publish( &fanoutData.rings[ 0 ], size );
+        }
+        else
+        {
+            ReadPort( fanoutData.pRxBuffer, size, position );
+            for ( unsigned r = 0; r < numRings; ++r )
+            {
+                BcastRing_Write( &fanoutData.rings[ r ], fanoutData.pRxBuffer, size );
+            }
+        }
+        position += size;
+    }
+    for ( unsigned r = 0; r < numRings; ++r )
+    {
+        BcastRing_Close( &fanoutData.rings[ r ] );
+    }
+
+    WaitForMultipleObjects( numThreads, handles, TRUE, INFINITE );
+    uint64_t end = start;
+    BOOL     ok  = TRUE;
+    for ( unsigned i = 0; i < numThreads; ++i )
+    {
+        tConsumerThread* pThread = &fanoutData.threads[ i ];
+        CloseHandle( handles[ i ] );
+        if ( !pThread->monitor )
+        {
+            end = ( pThread->end > end ) ? pThread->end : end;
+            ok &= ( pThread->bytes == fanoutData.totalBytes && pThread->checksum == fanoutData.expectedChecksum );
+        }
+    }
+    for ( unsigned r = 0; r < numRings; ++r )
+    {
+        BcastRing_Destroy( &fanoutData.rings[ r ] );
+    }
+
+    double seconds = Timing_TicksToNs( end - start ) / 1e9;
+    double mbIn    = ( double ) fanoutData.totalBytes / 1e6 / seconds;
+    printf( "%9u %-10s %12.0f %12.0f %12u", fanoutData.numConsumers, modeNames[ mode ], mbIn,
+            mbIn * fanoutData.numConsumers, ( mode == FANOUT_MODE_BROADCAST ) ? 1 : 1 + numRings );
+    if ( fanoutData.monitor )
+    {
+        tConsumerThread const * pMonitor = &fanoutData.threads[ fanoutData.numConsumers ];
+        printf( " %13.1f%%", 100.0 * ( double ) pMonitor->lost / ( double ) fanoutData.totalBytes );
+    }
+    else
+    {
+        printf( " %14s", "-" );
+    }
+    printf( "%s\n", ok ? "" : " (DATA CORRUPTED)" );
+    return ok;
+}
+
+/* Consumer: checksum every byte in place. */
+static DWORD WINAPI ConsumerThread( LPVOID pThreadData )
+{
+    tConsumerThread* pThread = pThreadData;
+    tBcastSpan       span;
+
+    WaitForSingleObject( fanoutData.hStartEvent, INFINITE );
+    while ( BcastRing_Peek( pThread->pRing, pThread->consumer, &span ) )
+    {
+        uint64_t sum = Checksum( span.pData, span.size );
+
+        if ( pThread->monitor )
+        {
+            Sleep( MONITOR_DELAY_MS );
+        }
+        if ( BcastRing_Release( pThread->pRing, pThread->consumer, span.size ) )
+        {
+            pThread->checksum += sum;
+            pThread->bytes    += span.size;
+        }
+    }
+    pThread->lost = pThread->pRing->cursors[ pThread->consumer ].lostBytes;
+    pThread->end  = Timing_Now();
+    return 0;
+}
+
+/* "Read" size bytes from the port: copy them from the pattern, like ReadFile does from the driver's buffer. */
+static void ReadPort( uint8_t* pDest, size_t size, uint64_t position )
+{
+    while ( size > 0 )
+    {
+        size_t offset = ( size_t ) ( position & ( PATTERN_SIZE - 1 ) );
+        size_t n      = ( size < PATTERN_SIZE - offset ) ? size : PATTERN_SIZE - offset;
+
+        memcpy( pDest, fanoutData.pattern + offset, n );
+        pDest    += n;
+        position += n;
+        size     -= n;
+    }
+}
+
+/* Sum of bytes, standing in for a parser touching every byte. */
+static uint64_t Checksum( uint8_t const * pData, size_t size )
+{
+    uint64_t sum = 0;
+
+    for ( size_t i = 0; i < size; ++i )
+    {
+        sum += pData[ i ];
+    }
+    return sum;
+}
@@ -0,0 +1,32 @@
+/**
+ **********************************************************************************************************************
+ * @file       fanout.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Fan-out benchmark of received data: broadcast ring against a copy per consumer.
+ **********************************************************************************************************************
+ */
+
+#ifndef FANOUT_H
+#define FANOUT_H
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/*
+ * Stream synthetic RX data to 1, 2, 4 and 8 consumers, once through a shared broadcast ring and once copied into a
+ * ring per consumer, and print throughput. Arguments (after "fanout" on the command line):
+ *   -c consumers     Only run this number of consumers.
+ *   -m MiB           Data per run (default 256).
+ *   -s size          Bytes per read from the "port" (default 1024, the RX buffer size).
+ *   -r KiB           Ring size, power of two (default 64).
+ *   -l 1             Also attach a slow lossy monitor and report how much it lost.
+ * Returns process exit code.
+ */
+int Fanout_Run( int argc, char** argv );
+
+#endif /* FANOUT_H */
@@ -0,0 +1,325 @@
+/**
+ **********************************************************************************************************************
+ * @file       latency.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Loopback latency measurement of the serial configuration profiles.
+ *
+ * The time a byte reaches the UART is not observable from user mode, so each message is timed from just before
+ * WriteFile until the last byte has been returned by ReadFile. Subtracting the wire time of the message leaves the
+ * delay added by driver buffering, USB latency timers and read timeouts, which is what the profiles change.
+ **********************************************************************************************************************
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "latency.h"
+#include "serialcfg.h"
+#include "timing.h"
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* COM port name prefix (expanded to ex. \\\\.\\COM11) */
+#define PORT_PREFIX                 "\\\\.\\"
+
+/* Read buffer size, larger than any message like in an application that does not know message lengths. */
+#define LATENCY_RX_BUF_SIZE         ( 1024 )
+
+/* Max message size. */
+#define LATENCY_MAX_MESSAGE         ( 256 )
+
+/* Defaults. */
+#define DEFAULT_MESSAGES            ( 1000 )
+#define DEFAULT_MESSAGE_SIZE        ( 16 )
+
+/* A message not received within this time is lost. */
+#define MESSAGE_TIMEOUT_MS          ( 2000 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Holds data for the latency "module". */
+typedef struct sLatencyData
+{
+    char const * txName;                                /* Port written to.                       */
+    char const * rxName;                                /* Port read from.                        */
+    HANDLE       hTx;                                   /* Handle of port written to.             */
+    HANDLE       hRx;                                   /* Handle of port read from (may be hTx). */
+    OVERLAPPED   ovRead;                                /* Overlapped read.                       */
+    OVERLAPPED   ovWrite;                               /* Overlapped write.                      */
+    unsigned     numMessages;                           /* Messages per profile.                  */
+    unsigned     size;                                  /* Message size.                          */
+    DWORD        baudRate;                              /* Baud rate override, 0 = profile's.     */
+    char const * framing;                               /* Framing override, NULL = profile's.    */
+    uint64_t*    pLatencies;                            /* Latency per message (ticks).           */
+    uint8_t      txBuffer[ LATENCY_MAX_MESSAGE ];       /* Message sent.                          */
+    uint8_t      rxBuffer[ LATENCY_RX_BUF_SIZE ];       /* Message received.                      */
+} tLatencyData;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static HANDLE OpenPort( char const * name );
+static BOOL   RunProfile( tSerialProfile const * pProfile );
+static BOOL   Exchange( unsigned sequence, uint64_t* pLatency );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Statically allocated data for "module" latency. */
+static tLatencyData latencyData;
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+int Latency_Run( int argc, char** argv )
+{
+    char const * profileName    = NULL;
+    int          latencyTimerMs = -1;
+
+    memset( ( void * ) &latencyData, 0, sizeof( latencyData ) );
+    latencyData.numMessages = DEFAULT_MESSAGES;
+    latencyData.size        = DEFAULT_MESSAGE_SIZE;
+
+    for ( int i = 0; i + 1 < argc; i += 2 )
+    {
+        if      ( strcmp( argv[ i ], "-p" ) == 0 ) latencyData.txName      = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "-q" ) == 0 ) latencyData.rxName      = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "-r" ) == 0 ) profileName             = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "-b" ) == 0 ) latencyData.baudRate    = ( DWORD ) atoi( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "-f" ) == 0 ) latencyData.framing     = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "-n" ) == 0 ) latencyData.numMessages = ( unsigned ) atoi( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "-s" ) == 0 ) latencyData.size        = ( unsigned ) atoi( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "-t" ) == 0 ) latencyTimerMs          = atoi( argv[ i + 1 ] );
+        else argc = -1;
+    }
+    if ( latencyData.rxName == NULL )
+    {
+        latencyData.rxName = latencyData.txName;
+    }
+    if ( argc < 0 || ( argc % 2 ) != 0 || latencyData.txName == NULL || latencyData.numMessages == 0 ||
+         latencyData.size == 0 || latencyData.size > LATENCY_MAX_MESSAGE ||
+         ( profileName != NULL && strcmp( profileName, "all" ) != 0 &&
+           SerialConfig_FindProfile( profileName ) == NULL ) )
+    {
+        size_t                 count;
+        tSerialProfile const * pProfiles = SerialConfig_Profiles( &count );
+
+        printf( "Usage: SerialComm latency -p port [-q port] [-r profile|all] [-b baud] [-f framing] [-n messages] "
+                "[-s size (max %d)] [-t ftdi_latency_ms]\n\nProfiles:\n", LATENCY_MAX_MESSAGE );
+        for ( size_t i = 0; i < count; ++i )
+        {
+            printf( "  %-12s %s\n", pProfiles[ i ].name, pProfiles[ i ].description );
+        }
+        return 1;
+    }
+
+    /* Latency timer changes need a driver reload, so they are a separate step. */
+    if ( latencyTimerMs >= 0 )
+    {
+        BOOL ok = SerialConfig_SetFtdiLatencyTimer( latencyData.txName, ( DWORD ) latencyTimerMs );
+        if ( strcmp( latencyData.rxName, latencyData.txName ) != 0 )
+        {
+            ok &= SerialConfig_SetFtdiLatencyTimer( latencyData.rxName, ( DWORD ) latencyTimerMs );
+        }
+        return ok ? 0 : 1;
+    }
+
+    latencyData.hTx = OpenPort( latencyData.txName );
+    latencyData.hRx = ( strcmp( latencyData.rxName, latencyData.txName ) == 0 ) ? latencyData.hTx
+                                                                                : OpenPort( latencyData.rxName );
+    latencyData.ovRead.hEvent  = CreateEvent( NULL, TRUE, FALSE, NULL );
+    latencyData.ovWrite.hEvent = CreateEvent( NULL, TRUE, FALSE, NULL );
+    latencyData.pLatencies     = malloc( latencyData.numMessages * sizeof( uint64_t ) );
+
+    int result = 1;
+    if ( latencyData.hTx != INVALID_HANDLE_VALUE && latencyData.hRx != INVALID_HANDLE_VALUE &&
+         latencyData.ovRead.hEvent != NULL && latencyData.ovWrite.hEvent != NULL && latencyData.pLatencies != NULL )
+    {
+        size_t                 count;
+        tSerialProfile const * pProfiles = SerialConfig_Profiles( &count );
+
+        Timing_Init();
+        printf( "[LATENCY] %s -> %s, %u messages of %u bytes per profile\n\n", latencyData.txName, latencyData.rxName,
+                latencyData.numMessages, latencyData.size );
+        printf( "%-12s %8s %8s %10s %10s %10s %10s %10s %6s\n",
+                "profile", "baud", "framing", "wire us", "p50 us", "p90 us", "p99 us", "max us", "lost" );
+
+        result = 0;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            if ( profileName == NULL || strcmp( profileName, "all" ) == 0 ||
+                 strcmp( profileName, pProfiles[ i ].name ) == 0 )
+            {
+                result |= RunProfile( &pProfiles[ i ] ) ? 0 : 1;
+            }
+        }
+    }
+
+    if ( latencyData.hRx != latencyData.hTx && latencyData.hRx != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( latencyData.hRx );
+    }
+    if ( latencyData.hTx != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( latencyData.hTx );
+    }
+    if ( latencyData.ovRead.hEvent != NULL )
+    {
+        CloseHandle( latencyData.ovRead.hEvent );
+    }
+    if ( latencyData.ovWrite.hEvent != NULL )
+    {
+        CloseHandle( latencyData.ovWrite.hEvent );
+    }
+    free( latencyData.pLatencies );
+    return result;
+}
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+static HANDLE OpenPort( char const * name )
+{
+    char   path[ 32 ];
+    HANDLE hPort;
+
+    sprintf_s( path, sizeof( path ), "%s%s", PORT_PREFIX, name );
+    hPort = CreateFileA(
+        path,
+        GENERIC_READ | GENERIC_WRITE,   /* Read/write access.                   */
+        0,                              /* Exclusive access.                    */
+        NULL,                           /* No security attributes.              */
+        OPEN_EXISTING,                  /* Ports always exist.                  */
+        FILE_FLAG_OVERLAPPED,           /* Asynchronous, like the RX threads.   */
+        NULL                            /* No template.                         */
+    );
+    if ( hPort == INVALID_HANDLE_VALUE )
+    {
+        printf( "[LATENCY] Unable to open %s (%d)\n", name, GetLastError() );
+    }
+    return hPort;
+}
+
+/* Configure the port(s) with a profile and time all messages. */
+static BOOL RunProfile( tSerialProfile const * pProfile )
+{
+    tSerialConfig config = pProfile->config;
+    char          framing[ 8 ];
+    unsigned      received = 0;
+
+    if ( latencyData.baudRate != 0 )
+    {
+        config.baudRate = latencyData.baudRate;
+    }
+    if ( latencyData.framing != NULL && !SerialConfig_ParseFraming( &config, latencyData.framing ) )
+    {
+        printf( "[LATENCY] Invalid framing %s\n", latencyData.framing );
+        return FALSE;
+    }
+    if ( !SerialConfig_Apply( latencyData.hTx, &config ) ||
+         ( latencyData.hRx != latencyData.hTx && !SerialConfig_Apply( latencyData.hRx, &config ) ) )
+    {
+        return FALSE;
+    }
+    if ( config.latencyTimerMs != 0 )
+    {
+        /* Cannot be applied here, it needs a driver reload. */
+        printf( "[LATENCY] %s is meant for a %lu ms FTDI latency timer, which this run does not set (see -t).\n",
+                pProfile->name, config.latencyTimerMs );
+    }
+
+    for ( unsigned i = 0; i < latencyData.numMessages; ++i )
+    {
+        if ( Exchange( i, &latencyData.pLatencies[ received ] ) )
+        {
+            ++received;
+        }
+    }
+
+    sprintf_s( framing, sizeof( framing ), "%u%c%s", config.dataBits, "NOEMS"[ config.parity ],
+               ( config.stopBits == ONESTOPBIT ) ? "1" : ( config.stopBits == ONE5STOPBITS ) ? "1.5" : "2" );
+    Timing_Sort( latencyData.pLatencies, received );
+    printf( "%-12s %8lu %8s %10.1f %10.1f %10.1f %10.1f %10.1f %6u\n", pProfile->name, config.baudRate, framing,
+            SerialConfig_CharTimeNs( &config ) * latencyData.size / 1000.0,
+            Timing_TicksToNs( Timing_Percentile( latencyData.pLatencies, received, 0.50 ) ) / 1000.0,
+            Timing_TicksToNs( Timing_Percentile( latencyData.pLatencies, received, 0.90 ) ) / 1000.0,
+            Timing_TicksToNs( Timing_Percentile( latencyData.pLatencies, received, 0.99 ) ) / 1000.0,
+            received ? Timing_TicksToNs( latencyData.pLatencies[ received - 1 ] ) / 1000.0 : 0.0,
+            latencyData.numMessages - received );
+    return TRUE;
+}
+
+/* Send one message and read until all of it has arrived. FALSE if it was lost or corrupted. */
+static BOOL Exchange( unsigned sequence, uint64_t* pLatency )
+{
+    DWORD    n;
+    DWORD    received = 0;
+    uint64_t start;
+    uint64_t giveUp;
+
+    memset( latencyData.txBuffer, ( int ) ( sequence & 0xFF ), latencyData.size );
+    PurgeComm( latencyData.hRx, PURGE_RXCLEAR );
+
+    start  = Timing_Now();
+    giveUp = start + Timing_NsToTicks( MESSAGE_TIMEOUT_MS * 1000000ULL );
+    if ( !WriteFile( latencyData.hTx, latencyData.txBuffer, latencyData.size, NULL, &latencyData.ovWrite ) &&
+         GetLastError() != ERROR_IO_PENDING )
+    {
+        printf( "[LATENCY] WriteFile failed (%d)\n", GetLastError() );
+        return FALSE;
+    }
+
+    /* Read as an application would: ask for a full buffer and let the timeouts decide when to return. */
+    while ( received < latencyData.size && Timing_Now() < giveUp )
+    {
+        if ( !ReadFile( latencyData.hRx, latencyData.rxBuffer + received, LATENCY_RX_BUF_SIZE - received, NULL,
+                        &latencyData.ovRead ) )
+        {
+            if ( GetLastError() != ERROR_IO_PENDING )
+            {
+                break;
+            }
+            if ( WaitForSingleObject( latencyData.ovRead.hEvent, MESSAGE_TIMEOUT_MS ) != WAIT_OBJECT_0 )
+            {
+                CancelIo( latencyData.hRx );
+                GetOverlappedResult( latencyData.hRx, &latencyData.ovRead, &n, TRUE );
+                break;
+            }
+        }
+        if ( !GetOverlappedResult( latencyData.hRx, &latencyData.ovRead, &n, FALSE ) )
+        {
+            break;
+        }
+        received += n;
+    }
+    *pLatency = Timing_Now() - start;
+
+    GetOverlappedResult( latencyData.hTx, &latencyData.ovWrite, &n, TRUE );
+    return received >= latencyData.size &&
+           memcmp( latencyData.rxBuffer, latencyData.txBuffer, latencyData.size ) == 0;
+}
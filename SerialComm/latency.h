@@ -0,0 +1,36 @@
+/**
+ **********************************************************************************************************************
+ * @file       latency.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Loopback latency measurement of the serial configuration profiles.
+ **********************************************************************************************************************
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/*
+ * Send messages through a loopback and time each from write to complete read, for every profile. Arguments (after
+ * "latency" on the command line):
+ *   -p port          Port to write to, e.g. COM3 (required).
+ *   -q port          Port to read from, e.g. the other end of a null-modem or com0com pair (default: same as -p,
+ *                    with TX wired to RX).
+ *   -r profile       Profile to run (default: all).
+ *   -b baud          Override baud rate of the profiles.
+ *   -f framing       Override framing of the profiles, e.g. 8N1.
+ *   -n messages      Messages per profile (default 1000).
+ *   -s size          Message size in bytes (default 16).
+ *   -t ms            Only set the FTDI latency timer of the port(s) and exit.
+ * Returns process exit code.
+ */
+int Latency_Run( int argc, char** argv );
+
+#endif /* LATENCY_H */
@@ -9,9 +9,16 @@
  */
 
 #include <windows.h>
+#include <ctype.h>
 #include <stdio.h>
 #include <stdint.h>
 
+#include "bcastring.h"
+#include "fanout.h"
+#include "latency.h"
+#include "metrics.h"
+#include "serialcfg.h"
+
 /**
  **********************************************************************************************************************
  * Defines
@@ -24,9 +31,18 @@
 /* COM port name prefix (expanded to ex. \\\\.\\COM11) */
 #define COM_PORT_NAME               "\\\\.\\COM"
 
-/* RX buffer size in bytes. */
+/* Length of the device prefix of COM_PORT_NAME (\\.\). */
+#define COM_PORT_PREFIX_LEN         ( 4 )
+
+/* Largest read in bytes, claimed from the RX ring at a time. */
 #define RX_BUF_SIZE                 ( 1024 )
 
+/* RX ring size in bytes, power of two. */
+#define RX_RING_SIZE                ( 64 * 1024 )
+
+/* Most received bytes printed per console line by a port's monitor. */
+#define MONITOR_LINE_SIZE           ( 64 )
+
 /**
  **********************************************************************************************************************
  * Typedefs
@@ -36,19 +52,25 @@
  /* Holds data for thread */
 typedef struct sPort
 {
-    char        name[ 11 ];                 /* Name of COM port.                                                    */
-    HANDLE      threadHandle;               /* Handle to win32 thread for receiving data.                           */
-    OVERLAPPED  ovRead;                     /* Overlapped structures as we want to use the COM port asynchronously. */
-    OVERLAPPED  ovWrite;                    /* Overlapped structures as we want to use the COM port asynchronously. */
-    DWORD       baudRate;                   /* Baudrate of port.                                                    */
-    uint8_t     rxBuffer[ RX_BUF_SIZE ];    /* Buffer to store received data in.                                    */
-    uint8_t     id;                         /* ID of port.                                                          */
+    char          name[ 11 ];                /* Name of COM port.                                                    */
+    HANDLE        hPort;                     /* Handle to the open COM port, INVALID_HANDLE_VALUE if not open.       */
+    HANDLE        threadHandle;              /* Handle to win32 thread for receiving data.                           */
+    HANDLE        monitorHandle;             /* Handle to win32 thread printing received data.                       */
+    OVERLAPPED    ovRead;                    /* Overlapped structures as we want to use the COM port asynchronously. */
+    OVERLAPPED    ovWrite;                   /* Overlapped structures as we want to use the COM port asynchronously. */
+    tSerialConfig config;                    /* Configuration applied when the port is opened.                       */
+    tBcastRing    rxRing;                    /* Received data, read in place by every subsystem attached to it.      */
+    int           monitor;                   /* Consumer ID of the monitor thread in rxRing.                         */
+    uint8_t       id;                        /* ID of port.                                                          */
+    tMetricSlot*  pMetrics;                  /* Metrics slot of the port's RX thread.                                */
 } tPort;
 
 /* Holds data for main. */
 typedef struct sMainData
 {
-    tPort ports[ MAX_COM_PORTS ]; /* Data for all threads to be spawned. */
+    tPort     ports[ MAX_COM_PORTS ];   /* Data for all threads to be spawned.            */
+    tMetricId metricRxBytes;            /* Counter: bytes received per port.              */
+    tMetricId metricRxQueued;           /* Gauge: bytes waiting in the driver's RX queue. */
 } tMainData;
 
 /**
@@ -59,6 +81,10 @@ typedef struct sMainData
 
 /* Thread function. */
 static DWORD WINAPI RxThread( LPVOID pThreadData );
+static DWORD WINAPI MonitorThread( LPVOID pThreadData );
+
+static BOOL OpenPort( tPort* pPort );
+static void ClosePort( tPort* pPort );
 
 /**
  **********************************************************************************************************************
@@ -80,6 +106,15 @@ HANDLE ghStopEvent;
  */
 int main( int argc, char** argv )
 {
+    /* Run one of the benchmarks instead if asked to. */
+    if ( argc > 1 && strcmp( argv[ 1 ], "latency" ) == 0 )
+    {
+        return Latency_Run( argc - 2, argv + 2 );
+    }
+    if ( argc > 1 && strcmp( argv[ 1 ], "fanout" ) == 0 )
+    {
+        return Fanout_Run( argc - 2, argv + 2 );
+    }
 
     /* Initialize main data. */
     memset( ( void * ) &mainData.ports, 0, sizeof( mainData.ports ) );
@@ -90,15 +125,25 @@ int main( int argc, char** argv )
         NULL        /* No name.                  */
     );
 
+    /* Publish live metrics, one slot per port (ports run without them if this fails). */
+    Metrics_Init( "SerialComm" );
+    mainData.metricRxBytes  = Metrics_Register( "serialcomm_rx_bytes_total", METRIC_TYPE_COUNTER, "Bytes received." );
+    mainData.metricRxQueued = Metrics_Register( "serialcomm_rx_queued_bytes", METRIC_TYPE_GAUGE,
+                                                "Bytes waiting in the driver's receive queue." );
+
     /* Initialize port data. */
     for ( int i = 0; i < MAX_COM_PORTS; ++i )
     {
         tPort* pPort = ( mainData.ports + i );
-        pPort->baudRate     = 9600;
-        pPort->threadHandle = INVALID_HANDLE_VALUE;
+        pPort->config          = SerialConfig_FindProfile( "lowlatency" )->config;
+        pPort->config.baudRate = 9600;
+        pPort->threadHandle    = INVALID_HANDLE_VALUE;
+        pPort->monitorHandle   = INVALID_HANDLE_VALUE;
+        pPort->hPort           = INVALID_HANDLE_VALUE;
         memcpy( pPort->name, COM_PORT_NAME, sizeof( COM_PORT_NAME ) );
         unsigned nameOffset = strlen( COM_PORT_NAME );
         _itoa_s( i, (char *)pPort->name + nameOffset , sizeof( pPort->name ) - nameOffset, 10 );
+        OpenPort( pPort );
     }
 
     /* Wait for user input before continuing in main thread. */
@@ -107,6 +152,15 @@ int main( int argc, char** argv )
     /* Tell all threads to die by setting global stop event. */
     SetEvent( ghStopEvent );
 
+    /* Close the rings too, an RX thread may be asleep waiting for a consumer to make room. */
+    for ( int i = 0; i < MAX_COM_PORTS; ++i )
+    {
+        if ( mainData.ports[ i ].threadHandle != INVALID_HANDLE_VALUE )
+        {
+            BcastRing_Close( &mainData.ports[ i ].rxRing );
+        }
+    }
+
     /* Wait for threads to stop. */
     for ( int i = 0; i < MAX_COM_PORTS; ++i )
     {
@@ -116,8 +170,15 @@ int main( int argc, char** argv )
         }
         WaitForSingleObject( mainData.ports[ i ].threadHandle, INFINITE );
         CloseHandle( mainData.ports[ i ].threadHandle );
+        WaitForSingleObject( mainData.ports[ i ].monitorHandle, INFINITE );
+        CloseHandle( mainData.ports[ i ].monitorHandle );
+    }
+    for ( int i = 0; i < MAX_COM_PORTS; ++i )
+    {
+        ClosePort( &mainData.ports[ i ] );
     }
     CloseHandle( ghStopEvent );
+    Metrics_Shutdown();
 
     printf( "Goodbye from main!\n" );
     return 0;
@@ -130,8 +191,182 @@ int main( int argc, char** argv )
  **********************************************************************************************************************
  */
 
+/* Read the port straight into its RX ring until the stop event is set. */
 static DWORD WINAPI RxThread( LPVOID pThreadData )
 {
-    // TODO: Implement me!
+    tPort* pPort = pThreadData;
+    HANDLE arHandles[ 2 ];
+
+    /* Claim metrics slot named after the port (without device prefix). */
+    pPort->pMetrics = Metrics_AcquireSlot( pPort->name + COM_PORT_PREFIX_LEN );
+
+    arHandles[ 0 ] = ghStopEvent;
+    arHandles[ 1 ] = pPort->ovRead.hEvent;
+    while ( WaitForSingleObject( ghStopEvent, 0 ) == WAIT_TIMEOUT )
+    {
+        size_t   size  = RX_BUF_SIZE;
+        uint8_t* pSpan = BcastRing_Claim( &pPort->rxRing, &size );
+        DWORD    n     = 0;
+
+        if ( pSpan == NULL )
+        {
+            break;
+        }
+
+        /* The port's read timeouts decide when a read returns, possibly with nothing. */
+        if ( !ReadFile( pPort->hPort, pSpan, ( DWORD ) size, NULL, &pPort->ovRead ) )
+        {
+            if ( GetLastError() != ERROR_IO_PENDING )
+            {
+                printf( "[%s] ReadFile failed (%d)\n", pPort->name + COM_PORT_PREFIX_LEN, GetLastError() );
+                break;
+            }
+            if ( WaitForMultipleObjects( 2, arHandles, FALSE, INFINITE ) != WAIT_OBJECT_0 + 1 )
+            {
+                /* Stopping (or the wait failed), the read must not outlive the span and the OVERLAPPED. */
+                CancelIo( pPort->hPort );
+                GetOverlappedResult( pPort->hPort, &pPort->ovRead, &n, TRUE );
+                break;
+            }
+        }
+        if ( !GetOverlappedResult( pPort->hPort, &pPort->ovRead, &n, FALSE ) )
+        {
+            printf( "[%s] Read failed (%d)\n", pPort->name + COM_PORT_PREFIX_LEN, GetLastError() );
+            break;
+        }
+        if ( n > 0 )
+        {
+            BcastRing_Publish( &pPort->rxRing, n );
+            Metrics_CounterAdd( pPort->pMetrics, mainData.metricRxBytes, n );
+        }
+
+        /* Whatever the driver holds beyond this read is what the thread is behind by. */
+        COMSTAT comStat;
+        DWORD   errors;
+        if ( ClearCommError( pPort->hPort, &errors, &comStat ) )
+        {
+            Metrics_GaugeSet( pPort->pMetrics, mainData.metricRxQueued, comStat.cbInQue );
+        }
+    }
+
+    BcastRing_Close( &pPort->rxRing );
+    return 0;
+}
+
+/* Print what the port receives. Lossy, so that a slow console never holds up the RX thread. */
+static DWORD WINAPI MonitorThread( LPVOID pThreadData )
+{
+    tPort*     pPort = pThreadData;
+    tBcastSpan span;
+    char       line[ MONITOR_LINE_SIZE ];
+
+    /* Returns FALSE once the ring is closed and everything published has been printed. */
+    while ( BcastRing_Peek( &pPort->rxRing, pPort->monitor, &span ) )
+    {
+        size_t size = span.size < sizeof( line ) ? span.size : sizeof( line );
+
+        if ( span.lost > 0 )
+        {
+            printf( "[%s] (%llu bytes lost)\n", pPort->name + COM_PORT_PREFIX_LEN, ( unsigned long long ) span.lost );
+        }
+
+        /* Copy out first, the bytes are only known to be intact once released. */
+        for ( size_t i = 0; i < size; ++i )
+        {
+            line[ i ] = isprint( span.pData[ i ] ) ? ( char ) span.pData[ i ] : '.';
+        }
+        if ( BcastRing_Release( &pPort->rxRing, pPort->monitor, size ) )
+        {
+            printf( "[%s] %.*s\n", pPort->name + COM_PORT_PREFIX_LEN, ( int ) size, line );
+        }
+    }
     return 0;
+}
+
+/* Open a port if it exists, configure it and start its RX thread. Ports that do not exist are skipped silently. */
+static BOOL OpenPort( tPort* pPort )
+{
+    pPort->hPort = CreateFileA(
+        pPort->name,
+        GENERIC_READ | GENERIC_WRITE,   /* Read/write access.                   */
+        0,                              /* Exclusive access.                    */
+        NULL,                           /* No security attributes.              */
+        OPEN_EXISTING,                  /* Ports always exist.                  */
+        FILE_FLAG_OVERLAPPED,           /* Asynchronous.                        */
+        NULL                            /* No template.                         */
+    );
+    if ( pPort->hPort == INVALID_HANDLE_VALUE )
+    {
+        return FALSE;
+    }
+    if ( !SerialConfig_Apply( pPort->hPort, &pPort->config ) )
+    {
+        printf( "Unable to configure %s\n", pPort->name + COM_PORT_PREFIX_LEN );
+        ClosePort( pPort );
+        return FALSE;
+    }
+
+    pPort->ovRead.hEvent  = CreateEvent( NULL, TRUE, FALSE, NULL );
+    pPort->ovWrite.hEvent = CreateEvent( NULL, TRUE, FALSE, NULL );
+    if ( pPort->ovRead.hEvent == NULL || pPort->ovWrite.hEvent == NULL ||
+         !BcastRing_Init( &pPort->rxRing, RX_RING_SIZE ) )
+    {
+        printf( "Unable to set up %s\n", pPort->name + COM_PORT_PREFIX_LEN );
+        ClosePort( pPort );
+        return FALSE;
+    }
+
+    /* Consumers are added before the RX thread starts, so that they see every byte it publishes. */
+    pPort->monitor       = BcastRing_AddConsumer( &pPort->rxRing, TRUE );
+    pPort->monitorHandle = CreateThread( NULL, 0, MonitorThread, pPort, 0, NULL );
+    if ( pPort->monitorHandle == NULL )
+    {
+        printf( "Unable to create monitor thread of %s\n", pPort->name + COM_PORT_PREFIX_LEN );
+        pPort->monitorHandle = INVALID_HANDLE_VALUE;
+        ClosePort( pPort );
+        return FALSE;
+    }
+
+    pPort->threadHandle = CreateThread(
+        NULL,                  /* No security attributes.   */
+        0,                     /* Default stack size.       */
+        RxThread,              /* Thread function to start. */
+        pPort,                 /* Pointer to port data.     */
+        0,                     /* No creation flags.        */
+        NULL                   /* No win32 threadid.        */
+    );
+    if ( pPort->threadHandle == NULL )
+    {
+        printf( "Unable to create RX thread of %s\n", pPort->name + COM_PORT_PREFIX_LEN );
+        pPort->threadHandle = INVALID_HANDLE_VALUE;
+        BcastRing_Close( &pPort->rxRing );
+        WaitForSingleObject( pPort->monitorHandle, INFINITE );
+        CloseHandle( pPort->monitorHandle );
+        pPort->monitorHandle = INVALID_HANDLE_VALUE;
+        ClosePort( pPort );
+        return FALSE;
+    }
+    printf( "Opened %s at %lu baud\n", pPort->name + COM_PORT_PREFIX_LEN, pPort->config.baudRate );
+    return TRUE;
+}
+
+/* Release everything OpenPort() set up. The RX and monitor threads must have stopped. */
+static void ClosePort( tPort* pPort )
+{
+    if ( pPort->hPort != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( pPort->hPort );
+        pPort->hPort = INVALID_HANDLE_VALUE;
+    }
+    if ( pPort->ovRead.hEvent != NULL )
+    {
+        CloseHandle( pPort->ovRead.hEvent );
+        pPort->ovRead.hEvent = NULL;
+    }
+    if ( pPort->ovWrite.hEvent != NULL )
+    {
+        CloseHandle( pPort->ovWrite.hEvent );
+        pPort->ovWrite.hEvent = NULL;
+    }
+    BcastRing_Destroy( &pPort->rxRing );
 }
\ No newline at end of file
@@ -0,0 +1,241 @@
+/**
+ **********************************************************************************************************************
+ * @file       serialcfg.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Serial port configuration: line settings, flow control, timeouts, driver queues and latency profiles.
+ **********************************************************************************************************************
+ */
+
+#include "serialcfg.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Registry key with one subkey per FTDI device. */
+#define FTDI_BUS_KEY                "SYSTEM\\CurrentControlSet\\Enum\\FTDIBUS"
+
+/* Baud rate and framing shared by all profiles. */
+#define PROFILE_BAUD_RATE           ( 115200 )
+
+/* Number of built-in profiles. */
+#define NUM_PROFILES                ( sizeof( profiles ) / sizeof( profiles[ 0 ] ) )
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Built-in profiles, from the usual sample-code setup to lowest latency. */
+static tSerialProfile const profiles[] =
+{
+    {
+        "blocking",
+        "Wait for a full buffer, 100 ms total timeout.",
+        { PROFILE_BAUD_RATE, 8, NOPARITY, ONESTOPBIT, FLOW_CONTROL_NONE, { 0, 0, 100, 0, 0 }, 0, 0, 0 }
+    },
+    {
+        "interval",
+        "Return after a 20 ms gap between bytes.",
+        { PROFILE_BAUD_RATE, 8, NOPARITY, ONESTOPBIT, FLOW_CONTROL_NONE, { 20, 0, 0, 0, 0 }, 0, 0, 0 }
+    },
+    {
+        "lowlatency",
+        "Return as soon as any byte is queued, small queues, for a 1 ms FTDI latency timer.",
+        { PROFILE_BAUD_RATE, 8, NOPARITY, ONESTOPBIT, FLOW_CONTROL_NONE, { MAXDWORD, MAXDWORD, 1000, 0, 0 },
+          4096, 4096, 1 }
+    },
+    {
+        "polling",
+        "Never wait, return whatever is queued (busy polling), for a 1 ms FTDI latency timer.",
+        { PROFILE_BAUD_RATE, 8, NOPARITY, ONESTOPBIT, FLOW_CONTROL_NONE, { MAXDWORD, 0, 0, 0, 0 }, 4096, 4096, 1 }
+    },
+};
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+tSerialProfile const * SerialConfig_Profiles( size_t* pCount )
+{
+    *pCount = NUM_PROFILES;
+    return profiles;
+}
+
+tSerialProfile const * SerialConfig_FindProfile( char const * name )
+{
+    for ( size_t i = 0; i < NUM_PROFILES; ++i )
+    {
+        if ( strcmp( profiles[ i ].name, name ) == 0 )
+        {
+            return &profiles[ i ];
+        }
+    }
+    return NULL;
+}
+
+BOOL SerialConfig_ParseFraming( tSerialConfig* pConfig, char const * framing )
+{
+    BYTE parity;
+    BYTE stopBits;
+
+    if ( strlen( framing ) < 3 || framing[ 0 ] < '5' || framing[ 0 ] > '8' )
+    {
+        return FALSE;
+    }
+
+    switch ( framing[ 1 ] )
+    {
+    case 'N': case 'n': parity = NOPARITY;    break;
+    case 'O': case 'o': parity = ODDPARITY;   break;
+    case 'E': case 'e': parity = EVENPARITY;  break;
+    case 'M': case 'm': parity = MARKPARITY;  break;
+    case 'S': case 's': parity = SPACEPARITY; break;
+    default:            return FALSE;
+    }
+
+    if      ( strcmp( framing + 2, "1" ) == 0 )   stopBits = ONESTOPBIT;
+    else if ( strcmp( framing + 2, "1.5" ) == 0 ) stopBits = ONE5STOPBITS;
+    else if ( strcmp( framing + 2, "2" ) == 0 )   stopBits = TWOSTOPBITS;
+    else return FALSE;
+
+    pConfig->dataBits = ( BYTE ) ( framing[ 0 ] - '0' );
+    pConfig->parity   = parity;
+    pConfig->stopBits = stopBits;
+    return TRUE;
+}
+
+double SerialConfig_CharTimeNs( tSerialConfig const * pConfig )
+{
+    double bits = 1.0 + pConfig->dataBits + ( pConfig->parity != NOPARITY ? 1.0 : 0.0 );
+
+    bits += ( pConfig->stopBits == ONESTOPBIT ) ? 1.0 : ( pConfig->stopBits == ONE5STOPBITS ) ? 1.5 : 2.0;
+    return bits * 1e9 / pConfig->baudRate;
+}
+
+BOOL SerialConfig_Apply( HANDLE hPort, tSerialConfig const * pConfig )
+{
+    DCB          dcb;
+    COMMTIMEOUTS timeouts = pConfig->timeouts;
+
+    /* Queue sizes are only a recommendation to the driver, some ignore them. */
+    if ( pConfig->rxQueueSize != 0 || pConfig->txQueueSize != 0 )
+    {
+        if ( !SetupComm( hPort, pConfig->rxQueueSize, pConfig->txQueueSize ) )
+        {
+            printf( "[SERIAL] SetupComm failed (%d)\n", GetLastError() );
+            return FALSE;
+        }
+    }
+
+    ZeroMemory( &dcb, sizeof( dcb ) );
+    dcb.DCBlength = sizeof( dcb );
+    if ( !GetCommState( hPort, &dcb ) )
+    {
+        printf( "[SERIAL] GetCommState failed (%d)\n", GetLastError() );
+        return FALSE;
+    }
+
+    dcb.BaudRate          = pConfig->baudRate;
+    dcb.ByteSize          = pConfig->dataBits;
+    dcb.Parity            = pConfig->parity;
+    dcb.StopBits          = pConfig->stopBits;
+    dcb.fBinary           = TRUE;
+    dcb.fParity           = ( pConfig->parity != NOPARITY );
+    dcb.fOutxCtsFlow      = ( pConfig->flowControl == FLOW_CONTROL_RTSCTS );
+    dcb.fRtsControl       = ( pConfig->flowControl == FLOW_CONTROL_RTSCTS ) ? RTS_CONTROL_HANDSHAKE : RTS_CONTROL_ENABLE;
+    dcb.fOutxDsrFlow      = ( pConfig->flowControl == FLOW_CONTROL_DTRDSR );
+    dcb.fDtrControl       = ( pConfig->flowControl == FLOW_CONTROL_DTRDSR ) ? DTR_CONTROL_HANDSHAKE : DTR_CONTROL_ENABLE;
+    dcb.fDsrSensitivity   = FALSE;
+    dcb.fOutX             = ( pConfig->flowControl == FLOW_CONTROL_XONXOFF );
+    dcb.fInX              = ( pConfig->flowControl == FLOW_CONTROL_XONXOFF );
+    dcb.fTXContinueOnXoff = TRUE;
+    dcb.fErrorChar        = FALSE;
+    dcb.fNull             = FALSE;
+    dcb.fAbortOnError     = FALSE;
+    if ( !SetCommState( hPort, &dcb ) )
+    {
+        printf( "[SERIAL] SetCommState failed (%d)\n", GetLastError() );
+        return FALSE;
+    }
+
+    if ( !SetCommTimeouts( hPort, &timeouts ) )
+    {
+        printf( "[SERIAL] SetCommTimeouts failed (%d)\n", GetLastError() );
+        return FALSE;
+    }
+
+    /* Start from empty queues. */
+    PurgeComm( hPort, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR );
+    return TRUE;
+}
+
+BOOL SerialConfig_SetFtdiLatencyTimer( char const * portName, DWORD ms )
+{
+    HKEY hBus;
+    BOOL found = FALSE;
+    BOOL ok    = FALSE;
+
+    if ( RegOpenKeyExA( HKEY_LOCAL_MACHINE, FTDI_BUS_KEY, 0, KEY_READ, &hBus ) != ERROR_SUCCESS )
+    {
+        printf( "[SERIAL] No FTDI devices installed.\n" );
+        return FALSE;
+    }
+
+    /* Each device has "<device>\0000\Device Parameters" holding its PortName and LatencyTimer. */
+    for ( DWORD i = 0; !found; ++i )
+    {
+        char  device[ 256 ];
+        char  path[ 512 ];
+        char  name[ 32 ];
+        DWORD length = sizeof( device );
+        DWORD size   = sizeof( name ) - 1;
+        DWORD type;
+        HKEY  hParams;
+
+        if ( RegEnumKeyExA( hBus, i, device, &length, NULL, NULL, NULL, NULL ) != ERROR_SUCCESS )
+        {
+            break;
+        }
+        sprintf_s( path, sizeof( path ), "%s\\%s\\0000\\Device Parameters", FTDI_BUS_KEY, device );
+        if ( RegOpenKeyExA( HKEY_LOCAL_MACHINE, path, 0, KEY_READ | KEY_SET_VALUE, &hParams ) != ERROR_SUCCESS )
+        {
+            continue;
+        }
+
+        ZeroMemory( name, sizeof( name ) );
+        if ( RegQueryValueExA( hParams, "PortName", NULL, &type, ( LPBYTE ) name, &size ) == ERROR_SUCCESS &&
+             type == REG_SZ && _stricmp( name, portName ) == 0 )
+        {
+            found = TRUE;
+            ok    = ( RegSetValueExA( hParams, "LatencyTimer", 0, REG_DWORD, ( BYTE const * ) &ms,
+                                      sizeof( ms ) ) == ERROR_SUCCESS );
+        }
+        RegCloseKey( hParams );
+    }
+    RegCloseKey( hBus );
+
+    if ( !found )
+    {
+        printf( "[SERIAL] %s is not an FTDI port (or needs administrator rights to configure).\n", portName );
+    }
+    else if ( !ok )
+    {
+        printf( "[SERIAL] Unable to set latency timer of %s, run as administrator.\n", portName );
+    }
+    else
+    {
+        printf( "[SERIAL] Latency timer of %s set to %lu ms, replug the adapter to apply.\n", portName, ms );
+    }
+    return ok;
+}
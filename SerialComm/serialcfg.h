@@ -0,0 +1,89 @@
+/**
+ **********************************************************************************************************************
+ * @file       serialcfg.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Serial port configuration: line settings, flow control, timeouts, driver queues and latency profiles.
+ *
+ * Read latency on Windows is dominated by COMMTIMEOUTS (the counterpart of VMIN/VTIME on a POSIX tty) and, for FTDI
+ * USB adapters, by the driver's latency timer, which holds back partial USB packets for up to 16 ms by default. The
+ * profiles bundle the combinations worth comparing, see the latency mode in latency.c.
+ **********************************************************************************************************************
+ */
+
+#ifndef SERIALCFG_H
+#define SERIALCFG_H
+
+#include <windows.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Flow control. */
+typedef enum eFlowControl
+{
+    FLOW_CONTROL_NONE    = 0,
+    FLOW_CONTROL_RTSCTS  = 1,
+    FLOW_CONTROL_DTRDSR  = 2,
+    FLOW_CONTROL_XONXOFF = 3
+} tFlowControl;
+
+/* Complete configuration of a port. */
+typedef struct sSerialConfig
+{
+    DWORD        baudRate;          /* Bits per second.                                             */
+    BYTE         dataBits;          /* 5 - 8.                                                       */
+    BYTE         parity;            /* NOPARITY, ODDPARITY, EVENPARITY, MARKPARITY or SPACEPARITY.  */
+    BYTE         stopBits;          /* ONESTOPBIT, ONE5STOPBITS or TWOSTOPBITS.                     */
+    tFlowControl flowControl;       /* Handshaking.                                                 */
+    COMMTIMEOUTS timeouts;          /* Read/write timeouts.                                         */
+    DWORD        rxQueueSize;       /* Driver input queue (SetupComm), 0 = driver default.          */
+    DWORD        txQueueSize;       /* Driver output queue (SetupComm), 0 = driver default.         */
+    DWORD        latencyTimerMs;    /* FTDI latency timer it is meant for, 0 = any. Not applied.    */
+} tSerialConfig;
+
+/* Named configuration. */
+typedef struct sSerialProfile
+{
+    char const *  name;             /* Name used on the command line.   */
+    char const *  description;      /* One line summary.                */
+    tSerialConfig config;           /* Configuration.                   */
+} tSerialProfile;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/* All built-in profiles. */
+tSerialProfile const * SerialConfig_Profiles( size_t* pCount );
+
+/* Profile by name, NULL if there is none. */
+tSerialProfile const * SerialConfig_FindProfile( char const * name );
+
+/* Set data bits, parity and stop bits from a string like "8N1", "7E2" or "8O1.5". */
+BOOL SerialConfig_ParseFraming( tSerialConfig* pConfig, char const * framing );
+
+/* Time on the wire of one character (start, data, parity and stop bits). */
+double SerialConfig_CharTimeNs( tSerialConfig const * pConfig );
+
+/*
+ * Apply queue sizes, line settings, flow control and timeouts to an open port, and purge it. The FTDI latency timer
+ * only changes on a driver reload, so it is left to SerialConfig_SetFtdiLatencyTimer().
+ */
+BOOL SerialConfig_Apply( HANDLE hPort, tSerialConfig const * pConfig );
+
+/*
+ * Set the latency timer of the FTDI adapter behind a port (e.g. "COM3") in the registry. Needs administrator rights
+ * and takes effect the next time the driver loads the device (replug or disable/enable).
+ */
+BOOL SerialConfig_SetFtdiLatencyTimer( char const * portName, DWORD ms );
+
+#endif /* SERIALCFG_H */
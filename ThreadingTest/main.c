@@ -12,6 +12,12 @@
 #include <stdio.h>
 #include <stdint.h>
 
+#include "metrics.h"
+#include "pipeline.h"
+#include "syncbench.h"
+#include "tickpage.h"
+#include "timing.h"
+
 /**
  **********************************************************************************************************************
  * Defines
@@ -24,6 +30,15 @@
 /* Waitable timer period (in threads). 1s * NUM_THREADS in relative time (LARGE_INTEGER/FILETIME format) */
 #define WAITABLE_TIMER_PERIOD    ( NUM_THREADS * -10000000LL )
 
+/* Waitable timer period in microseconds. */
+#define WAITABLE_TIMER_PERIOD_US ( -WAITABLE_TIMER_PERIOD / 10 )
+
+/* Wake-ups later than this (in microseconds) count as missed deadlines. */
+#define DEADLINE_SLACK_US        ( 1000 )
+
+/* Longest a thread following a tick page sleeps before looking at the stop event. */
+#define TICK_WAIT_TIMEOUT_MS     ( 100 )
+
 /**
  **********************************************************************************************************************
  * Typedefs
@@ -40,7 +55,11 @@ typedef struct sThreadData
 /* Holds data for main. */
 typedef struct sMainData
 {
-    tThreadData threads[ NUM_THREADS ]; /* Data for all threads to be spawned. */
+    tThreadData     threads[ NUM_THREADS ]; /* Data for all threads to be spawned.          */
+    tTickSubscriber tickPage;               /* Tick page followed with -t, else not mapped. */
+    tMetricId       metricTicks;            /* Counter: timer wake-ups.                     */
+    tMetricId       metricMissed;           /* Counter: wake-ups later than slack.          */
+    tMetricId       metricWakeLatency;      /* Histogram: wake-up lateness in us.           */
 } tMainData;
 
 /**
@@ -49,8 +68,11 @@ typedef struct sMainData
  **********************************************************************************************************************
  */
 
-/* Thread function. */
+/* Thread functions, woken by a waitable timer of their own or by the tick page of another process. */
 static DWORD WINAPI ThreadFunction( LPVOID pThreadData );
+static DWORD WINAPI TickThreadFunction( LPVOID pThreadData );
+
+static void RecordWake( tMetricSlot* pMetrics, uint64_t latenessUs );
 
 /**
  **********************************************************************************************************************
@@ -72,9 +94,34 @@ HANDLE ghStopEvent;
  */
 int main( int argc, char** argv )
 {
+    /* Run one of the benchmarks instead of the thread demo if asked to. */
+    if ( argc > 1 && strcmp( argv[ 1 ], "bench" ) == 0 )
+    {
+        return SyncBench_Run( argc - 2, argv + 2 );
+    }
+    if ( argc > 1 && strcmp( argv[ 1 ], "pipeline" ) == 0 )
+    {
+        return Pipeline_Run( argc - 2, argv + 2 );
+    }
 
     /* Initialize main data. */
     memset( ( void * ) &mainData.threads, 0, sizeof( mainData.threads ) );
+    memset( ( void * ) &mainData.tickPage, 0, sizeof( mainData.tickPage ) );
+
+    /* Follow the tick another process publishes (ex. MultimediaTimerTest) instead of running timers of our own. */
+    if ( argc == 3 && strcmp( argv[ 1 ], "-t" ) == 0 )
+    {
+        if ( !TickPage_Open( &mainData.tickPage, argv[ 2 ] ) )
+        {
+            return 1;
+        }
+    }
+    else if ( argc != 1 )
+    {
+        printf( "Usage: %s [-t tick_page] | bench ... | pipeline ...\n", argv[ 0 ] );
+        return 1;
+    }
+
     ghStopEvent = CreateEvent(
         NULL,       /* No security attributes.   */
         TRUE,       /* Manual reset.             */
@@ -82,7 +129,17 @@ int main( int argc, char** argv )
         NULL        /* No name.                  */
     );
 
+    /* Publish live metrics (threads run without them if this fails). */
+    Metrics_Init( "ThreadingTest" );
+    mainData.metricTicks       = Metrics_Register( "threadingtest_ticks_total", METRIC_TYPE_COUNTER,
+                                                   "Timer (or tick page) wake-ups." );
+    mainData.metricMissed      = Metrics_Register( "threadingtest_missed_deadlines_total", METRIC_TYPE_COUNTER,
+                                                   "Wake-ups later than the deadline slack." );
+    mainData.metricWakeLatency = Metrics_Register( "threadingtest_wake_latency_us", METRIC_TYPE_HISTOGRAM,
+                                                   "Lateness of timer wake-ups in microseconds." );
+
     /* Create threads and start them. */
+    LPTHREAD_START_ROUTINE threadFunction = ( mainData.tickPage.pPage != NULL ) ? TickThreadFunction : ThreadFunction;
     for ( int i = 0; i < NUM_THREADS; ++i )
     {
         tThreadData* pThread = &mainData.threads[ i ];
@@ -91,7 +148,7 @@ int main( int argc, char** argv )
         pThread->threadHandle = CreateThread(
             NULL,               /* No security attributes.   */
             0,                  /* Default stack size.       */
-            ThreadFunction,     /* Thread function to start. */
+            threadFunction,     /* Thread function to start. */
             pThread,            /* Pointer to thread data.   */
             0,                  /* No creation flags.        */
             NULL                /* No win32 threadid(?).     */
@@ -115,6 +172,11 @@ int main( int argc, char** argv )
         CloseHandle( mainData.threads[ i ].threadHandle );
     }
     CloseHandle( ghStopEvent );
+    if ( mainData.tickPage.pPage != NULL )
+    {
+        TickPage_Close( &mainData.tickPage );
+    }
+    Metrics_Shutdown();
 
     printf( "Goodbye from main!\n" );
     return 0;
@@ -133,6 +195,8 @@ static DWORD WINAPI ThreadFunction( LPVOID pThreadData )
     HANDLE       waitableTimer = NULL;
     HANDLE       arHandles[ 2 ];
     int          helloCount    = 1;
+    tMetricSlot* pMetrics;
+    char         slotName[ METRICS_SLOT_NAME_LEN ];
 
     if ( pData == NULL )
     {
@@ -140,6 +204,10 @@ static DWORD WINAPI ThreadFunction( LPVOID pThreadData )
         return 0;
     }
 
+    /* Claim own metrics slot. */
+    sprintf_s( slotName, sizeof( slotName ), "Thread %d", pData->id );
+    pMetrics = Metrics_AcquireSlot( slotName );
+
     /* Add global event handle to array of handles. */
     arHandles[ 0 ] = ghStopEvent;
 
@@ -179,6 +247,11 @@ static DWORD WINAPI ThreadFunction( LPVOID pThreadData )
         return 0;
     }
 
+    /* Measure wake-up lateness from when the timer was (re)armed. */
+    LARGE_INTEGER armed, woken, frequency;
+    QueryPerformanceFrequency( &frequency );
+    QueryPerformanceCounter( &armed );
+
     /* Loop until error OR global stop event. */
     while ( TRUE )
     {
@@ -195,8 +268,14 @@ static DWORD WINAPI ThreadFunction( LPVOID pThreadData )
             case WAIT_OBJECT_0 + 1:
             {
                 /* Timer finished, */
+                QueryPerformanceCounter( &woken );
+                LONGLONG elapsedUs = ( woken.QuadPart - armed.QuadPart ) * 1000000 / frequency.QuadPart;
+                LONGLONG latenessUs = max( elapsedUs - WAITABLE_TIMER_PERIOD_US, 0 );
+                RecordWake( pMetrics, ( uint64_t ) latenessUs );
+
                 ++helloCount;
                 printf( "[THREAD %d] Hello again! (#%d)\n", pData->id, helloCount );
+                QueryPerformanceCounter( &armed );
                 if ( !SetWaitableTimer( waitableTimer, &liDueTime, 0, NULL, NULL, FALSE ) )
                 {
                     printf( "[THREAD %d] Unable to set waitable timer (%d)\n", pData->id, GetLastError() );
@@ -212,4 +291,64 @@ static DWORD WINAPI ThreadFunction( LPVOID pThreadData )
             }
         }
     }
+}
+
+/* Same as ThreadFunction, but every period is counted in ticks of the page instead of run on a timer of its own. */
+static DWORD WINAPI TickThreadFunction( LPVOID pThreadData )
+{
+    tThreadData*      pData      = pThreadData;
+    tTickPage const * pPage      = mainData.tickPage.pPage;
+    uint64_t          periodNs   = ( pPage->periodNs != 0 ) ? pPage->periodNs : 1;
+    uint64_t          numTicks   = ( WAITABLE_TIMER_PERIOD_US * 1000ULL + periodNs - 1 ) / periodNs;
+    int               helloCount = 1;
+    tMetricSlot*      pMetrics;
+    char              slotName[ METRICS_SLOT_NAME_LEN ];
+    tTickSample       sample;
+
+    /* Claim own metrics slot. */
+    sprintf_s( slotName, sizeof( slotName ), "Thread %d", pData->id );
+    pMetrics = Metrics_AcquireSlot( slotName );
+
+    /* Sleep for id number of seconds in order to not print at the same time (hopefully) (bad implementation). */
+    Sleep( pData->id * 1000 );
+    printf( "[THREAD %d] Hello! (every %llu ticks of the page)\n", pData->id, numTicks );
+
+    TickPage_Read( &mainData.tickPage, &sample );
+    uint64_t deadline = sample.tick + numTicks;
+
+    /* The page's wake events cannot be waited on together with the stop event, so time out now and then. */
+    while ( WaitForSingleObject( ghStopEvent, 0 ) == WAIT_TIMEOUT )
+    {
+        if ( !TickPage_Wait( &mainData.tickPage, deadline - 1, TICK_WAIT_TIMEOUT_MS, &sample ) )
+        {
+            continue;
+        }
+
+        /* Late by the time from the tick's publish to waking up, plus any ticks slept through. */
+        uint64_t now        = Timing_Now();
+        uint64_t latenessUs = ( sample.tick - deadline ) * periodNs / 1000;
+        if ( now > sample.timestamp && pPage->timestampHz != 0 )
+        {
+            latenessUs += ( now - sample.timestamp ) * 1000000 / pPage->timestampHz;
+        }
+        RecordWake( pMetrics, latenessUs );
+
+        ++helloCount;
+        printf( "[THREAD %d] Hello again! (#%d, tick %llu)\n", pData->id, helloCount, sample.tick );
+        deadline = sample.tick + numTicks;
+    }
+
+    printf( "[THREAD %d] Shutting down!\n", pData->id );
+    return 0;
+}
+
+/* Count a wake-up and how late it was. */
+static void RecordWake( tMetricSlot* pMetrics, uint64_t latenessUs )
+{
+    Metrics_CounterAdd( pMetrics, mainData.metricTicks, 1 );
+    Metrics_HistogramObserve( pMetrics, mainData.metricWakeLatency, latenessUs );
+    if ( latenessUs > DEADLINE_SLACK_US )
+    {
+        Metrics_CounterAdd( pMetrics, mainData.metricMissed, 1 );
+    }
 }
\ No newline at end of file
@@ -0,0 +1,611 @@
+/**
+ **********************************************************************************************************************
+ * @file       pipeline.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Multi-stage producer/consumer pipeline benchmark.
+ *
+ * A source thread stamps items and pushes them into the first queue, intermediate stages (one or more worker threads
+ * each) pop, do a fixed amount of calibrated work (loadgen.h) per item and push to the next queue, and a sink thread
+ * records end-to-end latency. Every queue is either a lock-free queue from lfqueue.h (SPSC, MPSC or MPMC depending on
+ * the number of threads on each side) with WaitOnAddress wakeups, or a CRITICAL_SECTION + CONDITION_VARIABLE ring as a
+ * baseline. The depth of every queue is published as a live gauge (see metrics.h), one slot per queue.
+ **********************************************************************************************************************
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lfqueue.h"
+#include "loadgen.h"
+#include "metrics.h"
+#include "pipeline.h"
+#include "timing.h"
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Max number of pipeline threads (also the limit of WaitForMultipleObjects). */
+#define PIPELINE_MAX_THREADS        ( 64 )
+
+/* Max number of stages, including source and sink. */
+#define PIPELINE_MAX_STAGES         ( 16 )
+
+/* Max items per push/pop. */
+#define PIPELINE_MAX_BATCH          ( 256 )
+
+/* Pops between two samples of a queue's depth, so that sampling does not add to the traffic on the queue. */
+#define PIPELINE_DEPTH_INTERVAL     ( 64 )
+
+/* Defaults. */
+#define DEFAULT_STAGES              ( 4 )
+#define DEFAULT_WORKERS             ( 1 )
+#define DEFAULT_ITEMS               ( 1000000 )
+#define DEFAULT_CAPACITY            ( 1024 )
+#define DEFAULT_WORK_NS             ( 20 )
+
+/* Number of queue implementations and default batch sizes. */
+#define NUM_IMPLS                   ( sizeof( queueImpls ) / sizeof( queueImpls[ 0 ] ) )
+#define NUM_DEFAULT_BATCHES         ( sizeof( defaultBatches ) / sizeof( defaultBatches[ 0 ] ) )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Item sent through the pipeline. */
+typedef struct sItem
+{
+    uint64_t created;   /* Timestamp when pushed by the source. */
+    uint32_t index;     /* Index in item array.                 */
+} tItem;
+
+/* Bounded ring protected by a critical section, the baseline. */
+typedef struct sLockedQueue
+{
+    CRITICAL_SECTION   lock;        /* Protects everything below.   */
+    CONDITION_VARIABLE notEmpty;    /* Signalled after a push.      */
+    CONDITION_VARIABLE notFull;     /* Signalled after a pop.       */
+    void**             ppItems;     /* Item array.                  */
+    size_t             capacity;    /* Size of item array.          */
+    size_t             head;        /* Index of oldest item.        */
+    size_t             count;       /* Number of queued items.      */
+    BOOL               closed;      /* No more pushes.              */
+} tLockedQueue;
+
+/* Queue between two stages. Only the member of the implementation under test is used. */
+typedef struct sPipeQueue
+{
+    tBlockingQueue lockFree;        /* Lock-free implementation.    */
+    tLockedQueue   locked;          /* Locked implementation.       */
+} tPipeQueue;
+
+/* A queue implementation under test. */
+typedef struct sQueueImpl
+{
+    char const * name;                                                              /* Name in results. */
+    BOOL   ( *init )( tPipeQueue* pQueue, tQueueKind kind, size_t capacity );
+    void   ( *destroy )( tPipeQueue* pQueue );
+    size_t ( *pushBatch )( tPipeQueue* pQueue, void* const * ppItems, size_t count );
+    size_t ( *popBatch )( tPipeQueue* pQueue, void** ppItems, size_t count );
+    void   ( *close )( tPipeQueue* pQueue );
+    size_t ( *depth )( tPipeQueue* pQueue );
+} tQueueImpl;
+
+/* Holds data for a pipeline thread. */
+typedef struct __declspec( align( 64 ) ) sStageThread
+{
+    HANDLE   threadHandle;  /* Handle to win32 thread itself. */
+    uint8_t  id;            /* ID of thread.                  */
+    unsigned stage;         /* Stage the thread works in.     */
+    unsigned worker;        /* Index of thread in its stage.  */
+    tLoadGen load;          /* Thread's copy of the load.     */
+} tStageThread;
+
+/* Holds data for the pipeline "module". */
+typedef struct sPipelineData
+{
+    tQueueImpl const * pImpl;                                   /* Implementation under test.             */
+    tPipeQueue         queues[ PIPELINE_MAX_STAGES - 1 ];       /* Queue after each stage but the last.   */
+    tStageThread       threads[ PIPELINE_MAX_THREADS ];         /* Pipeline threads.                      */
+    volatile LONG      activeWorkers[ PIPELINE_MAX_STAGES ];    /* Workers per stage still running.       */
+    HANDLE             hStartEvent;                             /* Released when all threads exist.       */
+    unsigned           numStages;                               /* Stages including source and sink.      */
+    unsigned           workers;                                 /* Threads per intermediate stage.        */
+    unsigned           numItems;                                /* Items per run.                         */
+    unsigned           batch;                                   /* Max items per push/pop.                */
+    unsigned           workNs;                                  /* Work per item and stage (ns).          */
+    uint64_t           workUnits;                               /* Load units for workNs.                 */
+    tLoadGen           load;                                    /* Calibrated CPU load.                   */
+    tItem*             pItems;                                  /* Items.                                 */
+    uint64_t*          pLatencies;                              /* End-to-end latency per item (ticks).   */
+    uint64_t           start;                                   /* Timestamp of first push.               */
+    uint64_t           end;                                     /* Timestamp of last pop in sink.         */
+    volatile uint64_t  sink;                                    /* Result of work.                        */
+    uint64_t           received;                                /* Items received by sink.                */
+    tMetricId          metricDepth;                             /* Gauge: items queued.                   */
+    tMetricSlot*       pDepthSlots[ PIPELINE_MAX_STAGES - 1 ];  /* Slot per queue, see StageThread().     */
+} tPipelineData;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static DWORD WINAPI StageThread( LPVOID pThreadData );
+static unsigned     WorkersOf( unsigned stage );
+static tQueueKind   KindOf( unsigned stage );
+static BOOL         RunOnce( tQueueImpl const * pImpl, unsigned capacity );
+
+static BOOL   LockFreeInit( tPipeQueue* pQueue, tQueueKind kind, size_t capacity );
+static void   LockFreeDestroy( tPipeQueue* pQueue );
+static size_t LockFreePushBatch( tPipeQueue* pQueue, void* const * ppItems, size_t count );
+static size_t LockFreePopBatch( tPipeQueue* pQueue, void** ppItems, size_t count );
+static void   LockFreeClose( tPipeQueue* pQueue );
+static size_t LockFreeDepth( tPipeQueue* pQueue );
+static BOOL   LockedInit( tPipeQueue* pQueue, tQueueKind kind, size_t capacity );
+static void   LockedDestroy( tPipeQueue* pQueue );
+static size_t LockedPushBatch( tPipeQueue* pQueue, void* const * ppItems, size_t count );
+static size_t LockedPopBatch( tPipeQueue* pQueue, void** ppItems, size_t count );
+static void   LockedClose( tPipeQueue* pQueue );
+static size_t LockedDepth( tPipeQueue* pQueue );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Statically allocated data for "module" pipeline. */
+static tPipelineData pipelineData;
+
+/* Queue implementations under test. */
+static tQueueImpl const queueImpls[] =
+{
+    { "lockfree", LockFreeInit, LockFreeDestroy, LockFreePushBatch, LockFreePopBatch, LockFreeClose, LockFreeDepth },
+    { "locked",   LockedInit,   LockedDestroy,   LockedPushBatch,   LockedPopBatch,   LockedClose,   LockedDepth   },
+};
+
+/* Batch sizes run when none is given. */
+static unsigned const defaultBatches[] = { 1, 8, 64 };
+
+/* Names of queue kinds, indexed by tQueueKind. */
+static char const * const queueKindNames[] = { "SPSC", "MPSC", "MPMC" };
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+int Pipeline_Run( int argc, char** argv )
+{
+    unsigned capacity = DEFAULT_CAPACITY;
+    unsigned batch    = 0;
+
+    memset( ( void * ) &pipelineData, 0, sizeof( pipelineData ) );
+    pipelineData.numStages = DEFAULT_STAGES;
+    pipelineData.workers   = DEFAULT_WORKERS;
+    pipelineData.numItems  = DEFAULT_ITEMS;
+    pipelineData.workNs    = DEFAULT_WORK_NS;
+
+    for ( int i = 0; i + 1 < argc; i += 2 )
+    {
+        unsigned value = ( unsigned ) atoi( argv[ i + 1 ] );
+        if      ( strcmp( argv[ i ], "-s" ) == 0 ) pipelineData.numStages = value;
+        else if ( strcmp( argv[ i ], "-w" ) == 0 ) pipelineData.workers   = value;
+        else if ( strcmp( argv[ i ], "-n" ) == 0 ) pipelineData.numItems  = value;
+        else if ( strcmp( argv[ i ], "-b" ) == 0 ) batch                  = value;
+        else if ( strcmp( argv[ i ], "-c" ) == 0 ) capacity               = value;
+        else if ( strcmp( argv[ i ], "-l" ) == 0 ) pipelineData.workNs    = value;
+        else argc = -1;
+    }
+
+    unsigned numThreads = 2 + ( pipelineData.numStages - 2 ) * pipelineData.workers;
+    if ( argc < 0 || ( argc % 2 ) != 0 || pipelineData.numStages < 2 || pipelineData.numStages > PIPELINE_MAX_STAGES ||
+         pipelineData.workers < 1 || numThreads > PIPELINE_MAX_THREADS || pipelineData.numItems < 1 ||
+         batch > PIPELINE_MAX_BATCH || capacity < 2 || ( capacity & ( capacity - 1 ) ) != 0 )
+    {
+        printf( "Usage: pipeline [-s stages] [-w workers] [-n items] [-b batch] [-c capacity (power of two)] "
+                "[-l work_ns]\n" );
+        return 1;
+    }
+
+    pipelineData.pItems      = malloc( pipelineData.numItems * sizeof( tItem ) );
+    pipelineData.pLatencies  = malloc( pipelineData.numItems * sizeof( uint64_t ) );
+    pipelineData.hStartEvent = CreateEvent(
+        NULL,       /* No security attributes.   */
+        TRUE,       /* Manual reset.             */
+        FALSE,      /* Initial state FALSE.      */
+        NULL        /* No name.                  */
+    );
+    if ( pipelineData.pItems == NULL || pipelineData.pLatencies == NULL || pipelineData.hStartEvent == NULL )
+    {
+        printf( "[PIPELINE] Unable to allocate benchmark resources.\n" );
+        free( pipelineData.pItems );
+        free( pipelineData.pLatencies );
+        return 1;
+    }
+
+    printf( "[PIPELINE] Calibrating timer and load...\n" );
+    Timing_Init();
+    if ( !LoadGen_Init( &pipelineData.load, LOAD_KIND_CPU, 0 ) )
+    {
+        printf( "[PIPELINE] Unable to set up load.\n" );
+        CloseHandle( pipelineData.hStartEvent );
+        free( pipelineData.pItems );
+        free( pipelineData.pLatencies );
+        return 1;
+    }
+    pipelineData.workUnits = ( uint64_t ) ( pipelineData.workNs / pipelineData.load.nsPerUnit + 0.5 );
+
+    /* Publish queue depths (the benchmark runs without them if this fails). */
+    Metrics_Init( "ThreadingTest" );
+    pipelineData.metricDepth = Metrics_Register( "pipeline_queue_depth", METRIC_TYPE_GAUGE,
+                                                 "Items waiting in the queue after a stage." );
+    for ( unsigned s = 0; s + 1 < pipelineData.numStages; ++s )
+    {
+        char slotName[ METRICS_SLOT_NAME_LEN ];
+        sprintf_s( slotName, sizeof( slotName ), "queue%u", s );
+        pipelineData.pDepthSlots[ s ] = Metrics_AcquireSlot( slotName );
+    }
+
+    printf( "[PIPELINE] %u items, queue capacity %u, %u ns of work per stage:", pipelineData.numItems, capacity,
+            pipelineData.workNs );
+    for ( unsigned s = 0; s < pipelineData.numStages; ++s )
+    {
+        printf( " [%u thread%s]", WorkersOf( s ), WorkersOf( s ) > 1 ? "s" : "" );
+        if ( s + 1 < pipelineData.numStages )
+        {
+            printf( " -%s->", queueKindNames[ KindOf( s ) ] );
+        }
+    }
+    printf( "\n\n%-10s %6s %14s %10s %10s %10s %10s %12s\n",
+            "queue", "batch", "items/s", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns" );
+
+    BOOL ok = TRUE;
+    for ( unsigned b = 0; b < ( batch ? 1 : NUM_DEFAULT_BATCHES ); ++b )
+    {
+        pipelineData.batch = batch ? batch : defaultBatches[ b ];
+        for ( unsigned i = 0; i < NUM_IMPLS; ++i )
+        {
+            ok &= RunOnce( &queueImpls[ i ], capacity );
+        }
+    }
+
+    Metrics_Shutdown();
+    LoadGen_Destroy( &pipelineData.load );
+    CloseHandle( pipelineData.hStartEvent );
+    free( pipelineData.pItems );
+    free( pipelineData.pLatencies );
+    return ok ? 0 : 1;
+}
+
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/* Number of threads in a stage: one for source and sink. */
+static unsigned WorkersOf( unsigned stage )
+{
+    return ( stage == 0 || stage == pipelineData.numStages - 1 ) ? 1 : pipelineData.workers;
+}
+
+/* Cheapest lock-free queue kind for the queue after a stage. */
+static tQueueKind KindOf( unsigned stage )
+{
+    unsigned producers = WorkersOf( stage );
+    unsigned consumers = WorkersOf( stage + 1 );
+
+    if ( consumers > 1 )
+    {
+        return QUEUE_KIND_MPMC;
+    }
+    return ( producers > 1 ) ? QUEUE_KIND_MPSC : QUEUE_KIND_SPSC;
+}
+
+/* Send all items through the pipeline once and print the result. */
+static BOOL RunOnce( tQueueImpl const * pImpl, unsigned capacity )
+{
+    HANDLE   handles[ PIPELINE_MAX_THREADS ];
+    unsigned numThreads = 0;
+    BOOL     started    = TRUE;
+
+    pipelineData.pImpl    = pImpl;
+    pipelineData.received = 0;
+    for ( unsigned s = 0; s + 1 < pipelineData.numStages; ++s )
+    {
+        if ( !pImpl->init( &pipelineData.queues[ s ], KindOf( s ), capacity ) )
+        {
+            printf( "[PIPELINE] Unable to create queue %u\n", s );
+            return FALSE;
+        }
+    }
+
+    ResetEvent( pipelineData.hStartEvent );
+    for ( unsigned s = 0; started && s < pipelineData.numStages; ++s )
+    {
+        pipelineData.activeWorkers[ s ] = WorkersOf( s );
+        for ( unsigned w = 0; started && w < WorkersOf( s ); ++w )
+        {
+            tStageThread* pThread = &pipelineData.threads[ numThreads ];
+            pThread->id           = ( uint8_t ) numThreads;
+            pThread->stage        = s;
+            pThread->worker       = w;
+            pThread->load         = pipelineData.load;  /* The CPU kernel owns no buffers, a copy is independent. */
+            pThread->threadHandle = CreateThread( NULL, 0, StageThread, pThread, 0, NULL );
+            if ( pThread->threadHandle == NULL )
+            {
+                printf( "[PIPELINE] Unable to create thread (%d)\n", GetLastError() );
+                started = FALSE;
+                continue;
+            }
+            handles[ numThreads++ ] = pThread->threadHandle;
+        }
+    }
+
+    /* A missing thread would stall the pipeline forever, so close the queues and let the started threads run out. */
+    if ( !started )
+    {
+        for ( unsigned s = 0; s + 1 < pipelineData.numStages; ++s )
+        {
+            pImpl->close( &pipelineData.queues[ s ] );
+        }
+    }
+
+    SetEvent( pipelineData.hStartEvent );
+    WaitForMultipleObjects( numThreads, handles, TRUE, INFINITE );
+    for ( unsigned i = 0; i < numThreads; ++i )
+    {
+        CloseHandle( handles[ i ] );
+    }
+    for ( unsigned s = 0; s + 1 < pipelineData.numStages; ++s )
+    {
+        pImpl->destroy( &pipelineData.queues[ s ] );
+    }
+
+    if ( !started )
+    {
+        return FALSE;
+    }
+
+    /* Latencies are stored by item index, so those of lost items were never written and nothing sound is left. */
+    size_t count = pipelineData.numItems;
+    if ( pipelineData.received != count )
+    {
+        printf( "%-10s %6u %14s %10s %10s %10s %10s %12s (ITEMS LOST, %llu of %zu received)\n", pImpl->name,
+                pipelineData.batch, "-", "-", "-", "-", "-", "-", pipelineData.received, count );
+        return FALSE;
+    }
+    Timing_Sort( pipelineData.pLatencies, count );
+
+    printf( "%-10s %6u %14.0f %10.0f %10.0f %10.0f %10.0f %12.0f\n", pImpl->name, pipelineData.batch,
+            ( double ) count * 1e9 / Timing_TicksToNs( pipelineData.end - pipelineData.start ),
+            Timing_TicksToNs( Timing_Percentile( pipelineData.pLatencies, count, 0.50 ) ),
+            Timing_TicksToNs( Timing_Percentile( pipelineData.pLatencies, count, 0.90 ) ),
+            Timing_TicksToNs( Timing_Percentile( pipelineData.pLatencies, count, 0.99 ) ),
+            Timing_TicksToNs( Timing_Percentile( pipelineData.pLatencies, count, 0.999 ) ),
+            Timing_TicksToNs( pipelineData.pLatencies[ count - 1 ] ) );
+    return TRUE;
+}
+
+/* Thread of any stage. */
+static DWORD WINAPI StageThread( LPVOID pThreadData )
+{
+    tStageThread*      pThread = pThreadData;
+    tQueueImpl const * pImpl   = pipelineData.pImpl;
+    unsigned           stage   = pThread->stage;
+    unsigned           batch   = pipelineData.batch;
+    void*              items[ PIPELINE_MAX_BATCH ];
+    size_t             n;
+    unsigned           pops    = 0;
+
+    /* The first consumer of a queue samples its depth, so that each queue's slot has a single writer. */
+    tMetricSlot* pDepthSlot = ( stage > 0 && pThread->worker == 0 ) ? pipelineData.pDepthSlots[ stage - 1 ] : NULL;
+
+    WaitForSingleObject( pipelineData.hStartEvent, INFINITE );
+
+    if ( stage == 0 )
+    {
+        /* Source: stamp and push all items. */
+        tPipeQueue* pOut = &pipelineData.queues[ 0 ];
+        pipelineData.start = Timing_Now();
+        for ( unsigned i = 0; i < pipelineData.numItems; i += ( unsigned ) n )
+        {
+            n = min( batch, pipelineData.numItems - i );
+            uint64_t now = Timing_Now();
+            for ( size_t j = 0; j < n; ++j )
+            {
+                tItem* pItem   = &pipelineData.pItems[ i + j ];
+                pItem->created = now;
+                pItem->index   = i + ( uint32_t ) j;
+                items[ j ]     = pItem;
+            }
+            pImpl->pushBatch( pOut, items, n );
+        }
+        pImpl->close( pOut );
+    }
+    else if ( stage == pipelineData.numStages - 1 )
+    {
+        /* Sink: record end-to-end latency. */
+        tPipeQueue* pIn = &pipelineData.queues[ stage - 1 ];
+        while ( ( n = pImpl->popBatch( pIn, items, batch ) ) != 0 )
+        {
+            uint64_t now = Timing_Now();
+            if ( pDepthSlot != NULL && ++pops % PIPELINE_DEPTH_INTERVAL == 0 )
+            {
+                Metrics_GaugeSet( pDepthSlot, pipelineData.metricDepth, pImpl->depth( pIn ) );
+            }
+            for ( size_t j = 0; j < n; ++j )
+            {
+                tItem const * pItem = items[ j ];
+                pipelineData.pLatencies[ pItem->index ] = now - pItem->created;
+            }
+            pipelineData.received += n;
+        }
+        pipelineData.end = Timing_Now();
+    }
+    else
+    {
+        /* Intermediate stage: work on items and pass them on. The last worker to finish closes the next queue. */
+        tPipeQueue* pIn  = &pipelineData.queues[ stage - 1 ];
+        tPipeQueue* pOut = &pipelineData.queues[ stage ];
+        uint64_t    sink = pThread->id;
+        while ( ( n = pImpl->popBatch( pIn, items, batch ) ) != 0 )
+        {
+            if ( pDepthSlot != NULL && ++pops % PIPELINE_DEPTH_INTERVAL == 0 )
+            {
+                Metrics_GaugeSet( pDepthSlot, pipelineData.metricDepth, pImpl->depth( pIn ) );
+            }
+            for ( size_t j = 0; j < n; ++j )
+            {
+                sink += LoadGen_RunUnits( &pThread->load, pipelineData.workUnits );
+            }
+            pImpl->pushBatch( pOut, items, n );
+        }
+        pipelineData.sink = sink;
+        if ( InterlockedDecrement( &pipelineData.activeWorkers[ stage ] ) == 0 )
+        {
+            pImpl->close( pOut );
+        }
+    }
+    return 0;
+}
+
+/**
+ **********************************************************************************************************************
+ * Queue implementations
+ **********************************************************************************************************************
+ */
+
+/* Lock-free queues with WaitOnAddress wakeups (see lfqueue.h). */
+static BOOL LockFreeInit( tPipeQueue* pQueue, tQueueKind kind, size_t capacity )
+{
+    return BlockingQueue_Init( &pQueue->lockFree, kind, capacity );
+}
+
+static void LockFreeDestroy( tPipeQueue* pQueue )
+{
+    BlockingQueue_Destroy( &pQueue->lockFree );
+}
+
+static size_t LockFreePushBatch( tPipeQueue* pQueue, void* const * ppItems, size_t count )
+{
+    return BlockingQueue_PushBatch( &pQueue->lockFree, ppItems, count );
+}
+
+static size_t LockFreePopBatch( tPipeQueue* pQueue, void** ppItems, size_t count )
+{
+    return BlockingQueue_PopBatch( &pQueue->lockFree, ppItems, count );
+}
+
+static void LockFreeClose( tPipeQueue* pQueue )
+{
+    BlockingQueue_Close( &pQueue->lockFree );
+}
+
+static size_t LockFreeDepth( tPipeQueue* pQueue )
+{
+    return BlockingQueue_Depth( &pQueue->lockFree );
+}
+
+/* Ring protected by a critical section with condition variables. */
+static BOOL LockedInit( tPipeQueue* pQueue, tQueueKind kind, size_t capacity )
+{
+    tLockedQueue* pLocked = &pQueue->locked;
+
+    memset( ( void * ) pLocked, 0, sizeof( *pLocked ) );
+    pLocked->ppItems = malloc( capacity * sizeof( void * ) );
+    if ( pLocked->ppItems == NULL )
+    {
+        return FALSE;
+    }
+    pLocked->capacity = capacity;
+    InitializeCriticalSection( &pLocked->lock );
+    InitializeConditionVariable( &pLocked->notEmpty );
+    InitializeConditionVariable( &pLocked->notFull );
+    return TRUE;
+}
+
+static void LockedDestroy( tPipeQueue* pQueue )
+{
+    DeleteCriticalSection( &pQueue->locked.lock );
+    free( pQueue->locked.ppItems );
+}
+
+static size_t LockedPushBatch( tPipeQueue* pQueue, void* const * ppItems, size_t count )
+{
+    tLockedQueue* pLocked = &pQueue->locked;
+    size_t        pushed  = 0;
+
+    EnterCriticalSection( &pLocked->lock );
+    while ( pushed < count )
+    {
+        while ( pLocked->count == pLocked->capacity && !pLocked->closed )
+        {
+            SleepConditionVariableCS( &pLocked->notFull, &pLocked->lock, INFINITE );
+        }
+        if ( pLocked->closed )
+        {
+            break;
+        }
+        while ( pushed < count && pLocked->count < pLocked->capacity )
+        {
+            pLocked->ppItems[ ( pLocked->head + pLocked->count++ ) % pLocked->capacity ] = ppItems[ pushed++ ];
+        }
+        WakeAllConditionVariable( &pLocked->notEmpty );
+    }
+    LeaveCriticalSection( &pLocked->lock );
+    return pushed;
+}
+
+static size_t LockedPopBatch( tPipeQueue* pQueue, void** ppItems, size_t count )
+{
+    tLockedQueue* pLocked = &pQueue->locked;
+    size_t        popped  = 0;
+
+    EnterCriticalSection( &pLocked->lock );
+    while ( pLocked->count == 0 && !pLocked->closed )
+    {
+        SleepConditionVariableCS( &pLocked->notEmpty, &pLocked->lock, INFINITE );
+    }
+    while ( popped < count && pLocked->count > 0 )
+    {
+        ppItems[ popped++ ] = pLocked->ppItems[ pLocked->head ];
+        pLocked->head       = ( pLocked->head + 1 ) % pLocked->capacity;
+        --pLocked->count;
+    }
+    if ( popped != 0 )
+    {
+        WakeAllConditionVariable( &pLocked->notFull );
+    }
+    LeaveCriticalSection( &pLocked->lock );
+    return popped;
+}
+
+static void LockedClose( tPipeQueue* pQueue )
+{
+    EnterCriticalSection( &pQueue->locked.lock );
+    pQueue->locked.closed = TRUE;
+    LeaveCriticalSection( &pQueue->locked.lock );
+    WakeAllConditionVariable( &pQueue->locked.notEmpty );
+    WakeAllConditionVariable( &pQueue->locked.notFull );
+}
+
+/* Unlocked read of the count, a snapshot like BlockingQueue_Depth(). */
+static size_t LockedDepth( tPipeQueue* pQueue )
+{
+    return *( volatile size_t * ) &pQueue->locked.count;
+}
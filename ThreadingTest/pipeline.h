@@ -0,0 +1,32 @@
+/**
+ **********************************************************************************************************************
+ * @file       pipeline.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Multi-stage producer/consumer pipeline benchmark.
+ **********************************************************************************************************************
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/*
+ * Run the pipeline benchmark. Arguments (after "pipeline" on the command line):
+ *   -s stages      Number of stages including source and sink (default 4, min 2).
+ *   -w workers     Threads per intermediate stage (default 1).
+ *   -n items       Items sent through the pipeline (default 1000000).
+ *   -b batch       Max items per push/pop (default: run 1, 8 and 64).
+ *   -c capacity    Capacity of each queue, power of two (default 1024).
+ *   -u units       Work units per item in each intermediate stage (default 20).
+ * Returns process exit code.
+ */
+int Pipeline_Run( int argc, char** argv );
+
+#endif /* PIPELINE_H */
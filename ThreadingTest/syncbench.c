@@ -0,0 +1,761 @@
+/**
+ **********************************************************************************************************************
+ * @file       syncbench.c
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Synchronization primitive contention benchmark.
+ *
+ * Every primitive is used as a mutual exclusion lock around a critical section of configurable length. For each
+ * combination of primitive, thread count and critical-section length the benchmark reports throughput (lock
+ * acquisitions per second over all threads) and percentiles of the time spent acquiring the lock. A separate run
+ * compares per-thread counters in a packed thread data array (false sharing) with a cache-line padded one. Work inside
+ * and outside the lock is calibrated CPU load (loadgen.h), a fixed amount per acquisition.
+ **********************************************************************************************************************
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "loadgen.h"
+#include "syncbench.h"
+#include "timing.h"
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Max number of benchmark threads (also the limit of WaitForMultipleObjects). */
+#define SYNCBENCH_MAX_THREADS       ( 64 )
+
+/* Size of a cache line. */
+#define CACHE_LINE                  ( 64 )
+
+/* Default number of lock acquisitions per thread and run. */
+#define DEFAULT_ITERATIONS          ( 20000 )
+
+/* Work (ns as calibrated) done outside the lock between two acquisitions. */
+#define OUTSIDE_NS                  ( 50 )
+
+/* Spin count used for the spinning CRITICAL_SECTION variant. */
+#define CS_SPIN_COUNT               ( 4000 )
+
+/* Spin iterations before a spinlock waiter yields its time slice (keeps oversubscribed runs finite). */
+#define SPIN_YIELD_THRESHOLD        ( 1000 )
+
+/* Counter increments per thread in the false-sharing run. */
+#define FALSE_SHARING_ITERATIONS    ( 10000000 )
+
+/* Number of thread counts that may be run (1, 2, 4, ..., 64 and the max itself). */
+#define MAX_THREAD_COUNTS           ( 8 )
+
+/* Number of critical-section lengths and primitives. */
+#define NUM_CS_LENGTHS              ( sizeof( csLengths ) / sizeof( csLengths[ 0 ] ) )
+#define NUM_PRIMITIVES              ( sizeof( primitives ) / sizeof( primitives[ 0 ] ) )
+
+/* Max number of results (primitives * thread counts * critical-section lengths). */
+#define MAX_RESULTS                 ( 8 * MAX_THREAD_COUNTS * 3 )
+
+/**
+ **********************************************************************************************************************
+ * Typedefs
+ **********************************************************************************************************************
+ */
+
+/* Queue node of an MCS lock, one per thread. */
+typedef struct sMcsNode
+{
+    struct sMcsNode* volatile pNext;    /* Next waiter.                      */
+    volatile LONG             locked;   /* Non-zero while waiting for lock.  */
+} tMcsNode;
+
+/* State of the lock under test, on its own cache line. */
+typedef struct __declspec( align( CACHE_LINE ) ) sBenchLock
+{
+    union
+    {
+        HANDLE             hEvent;      /* Auto-reset event, signalled when free.        */
+        CRITICAL_SECTION   cs;          /* Critical section.                             */
+        SRWLOCK            srw;         /* Slim reader/writer lock (exclusive mode).     */
+        volatile LONG      futex;       /* 0 free, 1 locked, 2 locked with waiters.      */
+        struct
+        {
+            volatile LONG  next;        /* Next ticket to hand out.                      */
+            volatile LONG  serving;     /* Ticket currently holding the lock.            */
+        } ticket;
+        tMcsNode* volatile pMcsTail;    /* Tail of MCS queue.                            */
+    } u;
+    volatile uint64_t protectedCounter; /* Incremented under the lock, checked afterwards. */
+} tBenchLock;
+
+/* A primitive under test. */
+typedef struct sPrimitive
+{
+    char const * name;                                      /* Name in results.   */
+    BOOL ( *init )( tBenchLock* pLock );                    /* Initialize lock.   */
+    void ( *lock )( tBenchLock* pLock, tMcsNode* pNode );   /* Acquire lock.      */
+    void ( *unlock )( tBenchLock* pLock, tMcsNode* pNode ); /* Release lock.      */
+    void ( *destroy )( tBenchLock* pLock );                 /* Destroy lock.      */
+} tPrimitive;
+
+/* Parameters of one run. */
+typedef struct sRun
+{
+    tBenchLock         lock;            /* Lock under test.                       */
+    tPrimitive const * pPrimitive;      /* Primitive under test.                  */
+    unsigned           csNs;            /* Work inside the critical section (ns). */
+    uint64_t           csUnits;         /* Load units for csNs.                   */
+    uint64_t           outsideUnits;    /* Load units for OUTSIDE_NS.             */
+    unsigned           iterations;      /* Acquisitions per thread.               */
+} tRun;
+
+/* Holds data for a benchmark thread. Padded so that threads do not share cache lines. */
+typedef struct __declspec( align( CACHE_LINE ) ) sBenchThread
+{
+    HANDLE     threadHandle;    /* Handle to win32 thread itself.           */
+    uint8_t    id;              /* ID of thread.                            */
+    tRun*      pRun;            /* Run the thread takes part in.            */
+    uint64_t*  pSamples;        /* Acquire latency per iteration (ticks).   */
+    uint64_t   sink;            /* Result of work, keeps it from being optimized away. */
+    tMcsNode   mcsNode;         /* Queue node for the MCS lock.             */
+    tLoadGen   load;            /* Thread's copy of the calibrated load.    */
+} tBenchThread;
+
+/* Variant of ThreadingTest's tThreadData without padding: neighbours share cache lines. */
+typedef struct sThreadDataPacked
+{
+    HANDLE            threadHandle; /* Handle to win32 thread itself. */
+    uint8_t           id;           /* ID of thread.                  */
+    volatile uint64_t counter;      /* Incremented by the thread.     */
+} tThreadDataPacked;
+
+/* Variant of ThreadingTest's tThreadData padded to a cache line. */
+typedef struct __declspec( align( CACHE_LINE ) ) sThreadDataPadded
+{
+    HANDLE            threadHandle; /* Handle to win32 thread itself. */
+    uint8_t           id;           /* ID of thread.                  */
+    volatile uint64_t counter;      /* Incremented by the thread.     */
+} tThreadDataPadded;
+
+/* Result of one lock run. */
+typedef struct sResult
+{
+    char const * primitive;     /* Name of primitive.                   */
+    unsigned     threads;       /* Number of threads.                   */
+    unsigned     csNs;          /* Work inside critical section (ns).   */
+    double       opsPerSec;     /* Acquisitions per second, all threads. */
+    double       p50Ns;         /* Acquire latency percentiles.         */
+    double       p90Ns;
+    double       p99Ns;
+    double       p999Ns;
+    double       maxNs;
+    BOOL         ok;            /* Protected counter matched.           */
+} tResult;
+
+/* Result of one false-sharing run. */
+typedef struct sLayoutResult
+{
+    char const * layout;        /* "packed" or "padded".        */
+    unsigned     threads;       /* Number of threads.           */
+    double       nsPerOp;       /* Wall time per increment.     */
+} tLayoutResult;
+
+/* Holds data for the benchmark "module". */
+typedef struct sSyncBenchData
+{
+    tBenchThread      threads[ SYNCBENCH_MAX_THREADS ];           /* Benchmark threads.                 */
+    tThreadDataPacked packed[ SYNCBENCH_MAX_THREADS ];            /* Packed thread data.                */
+    tThreadDataPadded padded[ SYNCBENCH_MAX_THREADS ];            /* Padded thread data.                */
+    HANDLE            hStartEvent;                                /* Released when all threads exist.   */
+    unsigned          threadCounts[ MAX_THREAD_COUNTS ];          /* Thread counts to run.              */
+    unsigned          numThreadCounts;
+    tResult           results[ MAX_RESULTS ];                     /* Lock results.                      */
+    unsigned          numResults;
+    tLayoutResult     layoutResults[ 2 * MAX_THREAD_COUNTS ];     /* False-sharing results.             */
+    unsigned          numLayoutResults;
+    tLoadGen          load;                                       /* Calibrated CPU load.               */
+} tSyncBenchData;
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+static DWORD WINAPI LockWorker( LPVOID pThreadData );
+static DWORD WINAPI CounterWorker( LPVOID pCounter );
+static BOOL         RunLock( tPrimitive const * pPrimitive, unsigned numThreads, unsigned csNs,
+                             unsigned iterations, uint64_t* pSamples );
+static void         RunFalseSharing( unsigned numThreads );
+static double       RunThreads( unsigned numThreads, LPTHREAD_START_ROUTINE function, void** ppArgs );
+static void         PrintSummary( void );
+static void         WriteJson( FILE* pFile, unsigned iterations );
+
+static BOOL EventInit( tBenchLock* pLock );
+static void EventLock( tBenchLock* pLock, tMcsNode* pNode );
+static void EventUnlock( tBenchLock* pLock, tMcsNode* pNode );
+static void EventDestroy( tBenchLock* pLock );
+static BOOL CsInit( tBenchLock* pLock );
+static BOOL CsSpinInit( tBenchLock* pLock );
+static void CsLock( tBenchLock* pLock, tMcsNode* pNode );
+static void CsUnlock( tBenchLock* pLock, tMcsNode* pNode );
+static void CsDestroy( tBenchLock* pLock );
+static BOOL SrwInit( tBenchLock* pLock );
+static void SrwLock( tBenchLock* pLock, tMcsNode* pNode );
+static void SrwUnlock( tBenchLock* pLock, tMcsNode* pNode );
+static BOOL ZeroInit( tBenchLock* pLock );
+static void NoDestroy( tBenchLock* pLock );
+static void FutexLock( tBenchLock* pLock, tMcsNode* pNode );
+static void FutexUnlock( tBenchLock* pLock, tMcsNode* pNode );
+static void TicketLock( tBenchLock* pLock, tMcsNode* pNode );
+static void TicketUnlock( tBenchLock* pLock, tMcsNode* pNode );
+static void McsLock( tBenchLock* pLock, tMcsNode* pNode );
+static void McsUnlock( tBenchLock* pLock, tMcsNode* pNode );
+static void SpinWait( unsigned* pSpins );
+
+/**
+ **********************************************************************************************************************
+ * Defines
+ **********************************************************************************************************************
+ */
+
+/* Statically allocated data for "module" syncbench. */
+static tSyncBenchData benchData;
+
+/* Primitives under test. */
+static tPrimitive const primitives[] =
+{
+    { "event",                  EventInit,   EventLock,   EventUnlock,   EventDestroy },
+    { "critical_section",       CsInit,      CsLock,      CsUnlock,      CsDestroy    },
+    { "critical_section_spin",  CsSpinInit,  CsLock,      CsUnlock,      CsDestroy    },
+    { "srwlock",                SrwInit,     SrwLock,     SrwUnlock,     NoDestroy    },
+    { "wait_on_address",        ZeroInit,    FutexLock,   FutexUnlock,   NoDestroy    },
+    { "ticket_spinlock",        ZeroInit,    TicketLock,  TicketUnlock,  NoDestroy    },
+    { "mcs_spinlock",           ZeroInit,    McsLock,     McsUnlock,     NoDestroy    },
+};
+
+/* Critical-section lengths in ns of calibrated work. */
+static unsigned const csLengths[] = { 0, 100, 1000 };
+
+/**
+ **********************************************************************************************************************
+ * Public functions
+ **********************************************************************************************************************
+ */
+
+int SyncBench_Run( int argc, char** argv )
+{
+    unsigned     maxThreads = GetActiveProcessorCount( ALL_PROCESSOR_GROUPS );
+    unsigned     iterations = DEFAULT_ITERATIONS;
+    char const * jsonPath   = NULL;
+
+    for ( int i = 0; i < argc; ++i )
+    {
+        if ( strcmp( argv[ i ], "-t" ) == 0 && i + 1 < argc )
+        {
+            maxThreads = ( unsigned ) atoi( argv[ ++i ] );
+        }
+        else if ( strcmp( argv[ i ], "-i" ) == 0 && i + 1 < argc )
+        {
+            iterations = ( unsigned ) atoi( argv[ ++i ] );
+        }
+        else if ( strcmp( argv[ i ], "-j" ) == 0 && i + 1 < argc )
+        {
+            jsonPath = argv[ ++i ];
+        }
+        else
+        {
+            printf( "Usage: bench [-t max_threads] [-i iterations] [-j file.json|-]\n" );
+            return 1;
+        }
+    }
+    maxThreads = min( max( maxThreads, 1 ), SYNCBENCH_MAX_THREADS );
+    iterations = max( iterations, 1 );
+
+    /* 1, 2, 4, ... below max, then max itself. */
+    memset( ( void * ) &benchData, 0, sizeof( benchData ) );
+    for ( unsigned n = 1; n < maxThreads; n *= 2 )
+    {
+        benchData.threadCounts[ benchData.numThreadCounts++ ] = n;
+    }
+    benchData.threadCounts[ benchData.numThreadCounts++ ] = maxThreads;
+
+    uint64_t* pSamples = malloc( ( size_t ) maxThreads * iterations * sizeof( uint64_t ) );
+    benchData.hStartEvent = CreateEvent(
+        NULL,       /* No security attributes.   */
+        TRUE,       /* Manual reset.             */
+        FALSE,      /* Initial state FALSE.      */
+        NULL        /* No name.                  */
+    );
+    if ( pSamples == NULL || benchData.hStartEvent == NULL )
+    {
+        printf( "[BENCH] Unable to allocate benchmark resources.\n" );
+        free( pSamples );
+        return 1;
+    }
+
+    printf( "[BENCH] Calibrating timer and load...\n" );
+    Timing_Init();
+    if ( !LoadGen_Init( &benchData.load, LOAD_KIND_CPU, 0 ) )
+    {
+        printf( "[BENCH] Unable to set up load.\n" );
+        CloseHandle( benchData.hStartEvent );
+        free( pSamples );
+        return 1;
+    }
+    printf( "[BENCH] %u logical processors, up to %u threads, %u iterations per thread, %.2f ns per load unit.\n",
+            GetActiveProcessorCount( ALL_PROCESSOR_GROUPS ), maxThreads, iterations, benchData.load.nsPerUnit );
+
+    BOOL allOk = TRUE;
+    for ( unsigned p = 0; p < NUM_PRIMITIVES; ++p )
+    {
+        for ( unsigned c = 0; c < NUM_CS_LENGTHS; ++c )
+        {
+            for ( unsigned t = 0; t < benchData.numThreadCounts; ++t )
+            {
+                allOk &= RunLock( &primitives[ p ], benchData.threadCounts[ t ], csLengths[ c ], iterations, pSamples );
+            }
+        }
+    }
+    for ( unsigned t = 0; t < benchData.numThreadCounts; ++t )
+    {
+        RunFalseSharing( benchData.threadCounts[ t ] );
+    }
+
+    PrintSummary();
+
+    if ( jsonPath != NULL )
+    {
+        FILE* pFile = stdout;
+        if ( strcmp( jsonPath, "-" ) != 0 && fopen_s( &pFile, jsonPath, "w" ) != 0 )
+        {
+            printf( "[BENCH] Unable to open %s\n", jsonPath );
+            pFile = NULL;
+        }
+        if ( pFile != NULL )
+        {
+            WriteJson( pFile, iterations );
+            if ( pFile != stdout )
+            {
+                fclose( pFile );
+            }
+        }
+    }
+
+    LoadGen_Destroy( &benchData.load );
+    CloseHandle( benchData.hStartEvent );
+    free( pSamples );
+    return allOk ? 0 : 1;
+}
+
+
+/**
+ **********************************************************************************************************************
+ * Private functions
+ **********************************************************************************************************************
+ */
+
+/*
+ * Start threads, release them together and return the wall time in ns until all have finished, or a negative value if
+ * not all of them could be created.
+ */
+static double RunThreads( unsigned numThreads, LPTHREAD_START_ROUTINE function, void** ppArgs )
+{
+    HANDLE handles[ SYNCBENCH_MAX_THREADS ];
+    unsigned created = 0;
+
+    ResetEvent( benchData.hStartEvent );
+    for ( unsigned i = 0; i < numThreads; ++i )
+    {
+        handles[ created ] = CreateThread( NULL, 0, function, ppArgs[ i ], 0, NULL );
+        if ( handles[ created ] == NULL )
+        {
+            printf( "[BENCH] Unable to create thread %u (%d)\n", i, GetLastError() );
+            continue;
+        }
+        ++created;
+    }
+
+    /* Threads that did start still wait for the start event, so run them to the end even if the run is void. */
+    uint64_t start = Timing_Now();
+    SetEvent( benchData.hStartEvent );
+    WaitForMultipleObjects( created, handles, TRUE, INFINITE );
+    uint64_t end = Timing_Now();
+
+    for ( unsigned i = 0; i < created; ++i )
+    {
+        CloseHandle( handles[ i ] );
+    }
+    return ( created == numThreads ) ? Timing_TicksToNs( end - start ) : -1.0;
+}
+
+/* Run one primitive with numThreads threads and record the result. */
+static BOOL RunLock( tPrimitive const * pPrimitive, unsigned numThreads, unsigned csNs,
+                     unsigned iterations, uint64_t* pSamples )
+{
+    static tRun run;
+    void*       args[ SYNCBENCH_MAX_THREADS ];
+
+    memset( ( void * ) &run, 0, sizeof( run ) );
+    run.pPrimitive = pPrimitive;
+    run.csNs         = csNs;
+    run.csUnits      = ( uint64_t ) ( csNs / benchData.load.nsPerUnit + 0.5 );
+    run.outsideUnits = ( uint64_t ) ( OUTSIDE_NS / benchData.load.nsPerUnit + 0.5 );
+    run.iterations = iterations;
+    if ( !pPrimitive->init( &run.lock ) )
+    {
+        printf( "[BENCH] Unable to initialize %s\n", pPrimitive->name );
+        return FALSE;
+    }
+
+    for ( unsigned i = 0; i < numThreads; ++i )
+    {
+        tBenchThread* pThread = &benchData.threads[ i ];
+        memset( ( void * ) pThread, 0, sizeof( *pThread ) );
+        pThread->id       = ( uint8_t ) i;
+        pThread->pRun     = &run;
+        pThread->pSamples = pSamples + ( size_t ) i * iterations;
+        pThread->load     = benchData.load;  /* The CPU kernel owns no buffers, a copy is a generator of its own. */
+        args[ i ]         = pThread;
+    }
+
+    double wallNs = RunThreads( numThreads, LockWorker, args );
+    pPrimitive->destroy( &run.lock );
+    if ( wallNs < 0.0 )
+    {
+        /* Samples of the missing threads were never written, and fewer threads is not the run asked for. */
+        printf( "[BENCH] %-22s threads %2u cs %4u: aborted, not all threads started\n", pPrimitive->name, numThreads,
+                csNs );
+        return FALSE;
+    }
+
+    /* Samples of all threads are contiguous. */
+    size_t count = ( size_t ) numThreads * iterations;
+    Timing_Sort( pSamples, count );
+
+    tResult* pResult   = &benchData.results[ benchData.numResults++ ];
+    pResult->primitive = pPrimitive->name;
+    pResult->threads   = numThreads;
+    pResult->csNs      = csNs;
+    pResult->opsPerSec = ( double ) count * 1e9 / wallNs;
+    pResult->p50Ns     = Timing_TicksToNs( Timing_Percentile( pSamples, count, 0.50 ) );
+    pResult->p90Ns     = Timing_TicksToNs( Timing_Percentile( pSamples, count, 0.90 ) );
+    pResult->p99Ns     = Timing_TicksToNs( Timing_Percentile( pSamples, count, 0.99 ) );
+    pResult->p999Ns    = Timing_TicksToNs( Timing_Percentile( pSamples, count, 0.999 ) );
+    pResult->maxNs     = Timing_TicksToNs( pSamples[ count - 1 ] );
+    pResult->ok        = ( run.lock.protectedCounter == count );
+
+    printf( "[BENCH] %-22s threads %2u cs %4u: %10.0f ops/s%s\n", pPrimitive->name, numThreads, csNs,
+            pResult->opsPerSec, pResult->ok ? "" : " (COUNTER MISMATCH)" );
+    return pResult->ok;
+}
+
+/* Compare packed and padded per-thread counters. */
+static void RunFalseSharing( unsigned numThreads )
+{
+    void* args[ SYNCBENCH_MAX_THREADS ];
+
+    for ( int layout = 0; layout < 2; ++layout )
+    {
+        for ( unsigned i = 0; i < numThreads; ++i )
+        {
+            benchData.packed[ i ].counter = 0;
+            benchData.padded[ i ].counter = 0;
+            args[ i ] = ( layout == 0 ) ? ( void * ) &benchData.packed[ i ].counter
+                                        : ( void * ) &benchData.padded[ i ].counter;
+        }
+
+        double wallNs = RunThreads( numThreads, CounterWorker, args );
+        if ( wallNs < 0.0 )
+        {
+            continue;
+        }
+        tLayoutResult* pResult = &benchData.layoutResults[ benchData.numLayoutResults++ ];
+        pResult->layout  = ( layout == 0 ) ? "packed" : "padded";
+        pResult->threads = numThreads;
+        pResult->nsPerOp = wallNs / FALSE_SHARING_ITERATIONS;
+    }
+}
+
+/* Lock benchmark thread. */
+static DWORD WINAPI LockWorker( LPVOID pThreadData )
+{
+    tBenchThread*      pThread = pThreadData;
+    tRun*              pRun    = pThread->pRun;
+    tPrimitive const * pPrim   = pRun->pPrimitive;
+    uint64_t           sink    = pThread->id;
+
+    WaitForSingleObject( benchData.hStartEvent, INFINITE );
+
+    for ( unsigned i = 0; i < pRun->iterations; ++i )
+    {
+        uint64_t before = Timing_Now();
+        pPrim->lock( &pRun->lock, &pThread->mcsNode );
+        uint64_t acquired = Timing_Now();
+
+        ++pRun->lock.protectedCounter;
+        sink += LoadGen_RunUnits( &pThread->load, pRun->csUnits );
+
+        pPrim->unlock( &pRun->lock, &pThread->mcsNode );
+        pThread->pSamples[ i ] = acquired - before;
+        sink += LoadGen_RunUnits( &pThread->load, pRun->outsideUnits );
+    }
+
+    pThread->sink = sink;
+    return 0;
+}
+
+/* False-sharing benchmark thread. */
+static DWORD WINAPI CounterWorker( LPVOID pCounter )
+{
+    volatile uint64_t* pValue = pCounter;
+
+    WaitForSingleObject( benchData.hStartEvent, INFINITE );
+    for ( unsigned i = 0; i < FALSE_SHARING_ITERATIONS; ++i )
+    {
+        ++*pValue;
+    }
+    return 0;
+}
+
+/* Print summary table of all results. */
+static void PrintSummary( void )
+{
+    printf( "\n%-22s %7s %5s %12s %9s %9s %9s %9s %10s %3s\n",
+            "primitive", "threads", "cs", "ops/s", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns", "ok" );
+    for ( unsigned i = 0; i < benchData.numResults; ++i )
+    {
+        tResult const * pResult = &benchData.results[ i ];
+        printf( "%-22s %7u %5u %12.0f %9.0f %9.0f %9.0f %9.0f %10.0f %3s\n",
+                pResult->primitive, pResult->threads, pResult->csNs, pResult->opsPerSec, pResult->p50Ns,
+                pResult->p90Ns, pResult->p99Ns, pResult->p999Ns, pResult->maxNs, pResult->ok ? "yes" : "NO" );
+    }
+
+    printf( "\n%-22s %7s %12s\n", "thread data layout", "threads", "ns/op" );
+    for ( unsigned i = 0; i < benchData.numLayoutResults; ++i )
+    {
+        tLayoutResult const * pResult = &benchData.layoutResults[ i ];
+        printf( "%-22s %7u %12.2f\n", pResult->layout, pResult->threads, pResult->nsPerOp );
+    }
+}
+
+/* Write all results as JSON. */
+static void WriteJson( FILE* pFile, unsigned iterations )
+{
+    fprintf( pFile, "{\n  \"logical_processors\": %u,\n  \"iterations\": %u,\n  \"outside_ns\": %u,\n",
+             GetActiveProcessorCount( ALL_PROCESSOR_GROUPS ), iterations, OUTSIDE_NS );
+
+    fprintf( pFile, "  \"locks\": [\n" );
+    for ( unsigned i = 0; i < benchData.numResults; ++i )
+    {
+        tResult const * pResult = &benchData.results[ i ];
+        fprintf( pFile,
+                 "    { \"primitive\": \"%s\", \"threads\": %u, \"cs_ns\": %u, \"ops_per_sec\": %.0f, "
+                 "\"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f, \"p999_ns\": %.1f, \"max_ns\": %.1f, "
+                 "\"ok\": %s }%s\n",
+                 pResult->primitive, pResult->threads, pResult->csNs, pResult->opsPerSec, pResult->p50Ns,
+                 pResult->p90Ns, pResult->p99Ns, pResult->p999Ns, pResult->maxNs, pResult->ok ? "true" : "false",
+                 ( i + 1 < benchData.numResults ) ? "," : "" );
+    }
+    fprintf( pFile, "  ],\n" );
+
+    fprintf( pFile, "  \"false_sharing\": [\n" );
+    for ( unsigned i = 0; i < benchData.numLayoutResults; ++i )
+    {
+        tLayoutResult const * pResult = &benchData.layoutResults[ i ];
+        fprintf( pFile, "    { \"layout\": \"%s\", \"threads\": %u, \"ns_per_op\": %.3f }%s\n",
+                 pResult->layout, pResult->threads, pResult->nsPerOp,
+                 ( i + 1 < benchData.numLayoutResults ) ? "," : "" );
+    }
+    fprintf( pFile, "  ]\n}\n" );
+}
+
+/**
+ **********************************************************************************************************************
+ * Primitives
+ **********************************************************************************************************************
+ */
+
+/* Auto-reset event used as a lock: signalled means free. */
+static BOOL EventInit( tBenchLock* pLock )
+{
+    pLock->u.hEvent = CreateEvent(
+        NULL,       /* No security attributes.   */
+        FALSE,      /* Auto reset.               */
+        TRUE,       /* Initially free.           */
+        NULL        /* No name.                  */
+    );
+    return pLock->u.hEvent != NULL;
+}
+
+static void EventLock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    WaitForSingleObject( pLock->u.hEvent, INFINITE );
+}
+
+static void EventUnlock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    SetEvent( pLock->u.hEvent );
+}
+
+static void EventDestroy( tBenchLock* pLock )
+{
+    CloseHandle( pLock->u.hEvent );
+}
+
+/* CRITICAL_SECTION, without and with spinning before blocking. */
+static BOOL CsInit( tBenchLock* pLock )
+{
+    InitializeCriticalSection( &pLock->u.cs );
+    return TRUE;
+}
+
+static BOOL CsSpinInit( tBenchLock* pLock )
+{
+    return InitializeCriticalSectionAndSpinCount( &pLock->u.cs, CS_SPIN_COUNT );
+}
+
+static void CsLock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    EnterCriticalSection( &pLock->u.cs );
+}
+
+static void CsUnlock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    LeaveCriticalSection( &pLock->u.cs );
+}
+
+static void CsDestroy( tBenchLock* pLock )
+{
+    DeleteCriticalSection( &pLock->u.cs );
+}
+
+/* SRWLOCK in exclusive mode. */
+static BOOL SrwInit( tBenchLock* pLock )
+{
+    InitializeSRWLock( &pLock->u.srw );
+    return TRUE;
+}
+
+static void SrwLock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    AcquireSRWLockExclusive( &pLock->u.srw );
+}
+
+static void SrwUnlock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    ReleaseSRWLockExclusive( &pLock->u.srw );
+}
+
+/* Shared by the hand-written locks, their state starts out zeroed. */
+static BOOL ZeroInit( tBenchLock* pLock )
+{
+    memset( ( void * ) &pLock->u, 0, sizeof( pLock->u ) );
+    return TRUE;
+}
+
+static void NoDestroy( tBenchLock* pLock )
+{
+}
+
+/* Futex-style mutex on WaitOnAddress (three-state mutex as described by Drepper, "Futexes Are Tricky"). */
+static void FutexLock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    LONG contended = 2;
+    LONG state     = InterlockedCompareExchange( &pLock->u.futex, 1, 0 );
+
+    if ( state == 0 )
+    {
+        return;
+    }
+    if ( state != 2 )
+    {
+        state = InterlockedExchange( &pLock->u.futex, 2 );
+    }
+    while ( state != 0 )
+    {
+        WaitOnAddress( &pLock->u.futex, &contended, sizeof( contended ), INFINITE );
+        state = InterlockedExchange( &pLock->u.futex, 2 );
+    }
+}
+
+static void FutexUnlock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    if ( InterlockedExchange( &pLock->u.futex, 0 ) == 2 )
+    {
+        WakeByAddressSingle( ( PVOID ) &pLock->u.futex );
+    }
+}
+
+/* Ticket spinlock: FIFO, but all waiters spin on the same cache line. */
+static void TicketLock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    LONG     ticket = InterlockedIncrement( &pLock->u.ticket.next ) - 1;
+    unsigned spins  = 0;
+
+    while ( pLock->u.ticket.serving != ticket )
+    {
+        SpinWait( &spins );
+    }
+}
+
+static void TicketUnlock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    InterlockedIncrement( &pLock->u.ticket.serving );
+}
+
+/* MCS queue spinlock: FIFO, every waiter spins on its own node. */
+static void McsLock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    unsigned spins = 0;
+
+    pNode->pNext  = NULL;
+    pNode->locked = TRUE;
+
+    tMcsNode* pPrev = InterlockedExchangePointer( ( PVOID volatile * ) &pLock->u.pMcsTail, pNode );
+    if ( pPrev != NULL )
+    {
+        pPrev->pNext = pNode;
+        while ( pNode->locked )
+        {
+            SpinWait( &spins );
+        }
+    }
+    MemoryBarrier();
+}
+
+static void McsUnlock( tBenchLock* pLock, tMcsNode* pNode )
+{
+    if ( pNode->pNext == NULL )
+    {
+        /* No known successor, try to mark the lock free. */
+        if ( InterlockedCompareExchangePointer( ( PVOID volatile * ) &pLock->u.pMcsTail, NULL, pNode ) == pNode )
+        {
+            return;
+        }
+        /* A successor is enqueueing, wait for it to link itself. */
+        while ( pNode->pNext == NULL )
+        {
+            YieldProcessor();
+        }
+    }
+    InterlockedExchange( &pNode->pNext->locked, FALSE );
+}
+
+/* Pause inside a spin loop, yield the time slice now and then in case the lock holder is not running. */
+static void SpinWait( unsigned* pSpins )
+{
+    if ( ++*pSpins % SPIN_YIELD_THRESHOLD == 0 )
+    {
+        SwitchToThread();
+    }
+    else
+    {
+        YieldProcessor();
+    }
+}
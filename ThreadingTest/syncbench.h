@@ -0,0 +1,29 @@
+/**
+ **********************************************************************************************************************
+ * @file       syncbench.h
+ * @author     Simon Lvgren
+ * @date       2026
+ * @copyright  MIT License
+ * @brief      Synchronization primitive contention benchmark.
+ **********************************************************************************************************************
+ */
+
+#ifndef SYNCBENCH_H
+#define SYNCBENCH_H
+
+/**
+ **********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************
+ */
+
+/*
+ * Run the benchmark suite. Arguments (after "bench" on the command line):
+ *   -t max_threads   Highest thread count to run (default: number of logical processors, max 64).
+ *   -i iterations    Lock acquisitions per thread and run (default 20000).
+ *   -j file          Write machine-readable results as JSON to file ("-" for stdout).
+ * Returns process exit code.
+ */
+int SyncBench_Run( int argc, char** argv );
+
+#endif /* SYNCBENCH_H */